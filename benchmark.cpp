@@ -0,0 +1,1268 @@
+#include <iostream>
+#include <SearchingAlgo.h>
+#include <AdaptiveSearch.h>
+#include <BloomFilter.h>
+#include <CompressedArray.h>
+#include <ConcurrentIndex.h>
+#include <EytzingerIndex.h>
+#include <FixedSearch.h>
+#include <InterpolationIndex.h>
+#include <LearnedIndex.h>
+#include <LookupCache.h>
+#include <MappedArray.h>
+#include <ParallelSearch.h>
+#include <PerfCounters.h>
+#include <RangeSearch.h>
+#include <SetIntersection.h>
+#include <SortedTree.h>
+#include <StreamSearch.h>
+#include <thread>
+#include <atomic>
+#include <list>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <sstream>
+#include <iomanip>
+using namespace std;
+
+// Measure the searching functions and report one record per measurement.
+// Run the Release target, since the Debug target is not optimized.
+//
+// Usage: searchingAlgoBench [--suite grid|features|all] [--format text|csv|json] [--max-log2 N]
+//   --suite     grid: every SearchingAlgo method over sizes, element types, key distributions
+//                     and hit ratios; features: the specialised indexes and engines; all: both.
+//   --format    text table (default), CSV with a header line, or a JSON array of records.
+//   --max-log2  largest array size is 2^N elements (default 22, at most 30).
+// A lone number is taken as --max-log2.
+// Cache misses and branch mispredictions per operation come from the hardware counters where
+// the system allows it (Linux perf events), and are reported as empty otherwise.
+// The Instrumented target (SEARCHINGALGO_INSTRUMENT) adds a "stats" group with the probe counts
+// and latency percentiles of the searches; its timings include the cost of instrumentation.
+
+// One measurement.
+struct BenchRecord {
+    // Group of measurements, e.g. "grid" or "eytzinger".
+    string benchmark;
+    string method;
+    string type;
+    size_t size;
+    string distribution;
+    // Fraction of lookups for keys that are in the array.
+    double hitRatio;
+    size_t operations;
+    double totalNs;
+    size_t found;
+    // Per operation, negative when the counters are not available.
+    double cacheMisses;
+    double branchMisses;
+    // Anything else worth knowing about the measurement.
+    string note;
+};
+
+enum OutputFormat { formatText, formatCsv, formatJson };
+
+OutputFormat outputFormat = formatText;
+size_t recordsReported = 0;
+PerfCounters perfCounters;
+
+// Random number generator shared by all benchmarks. rand() only gives 15 bits on some platforms.
+mt19937_64 randomEngine(1);
+
+// Return a random number within the range of 0 to range - 1.
+size_t randomIndex(size_t range){
+    return randomEngine() % range;
+}
+
+// Return the time elapsed since start in nanoseconds.
+double elapsedNs(chrono::steady_clock::time_point start){
+    return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+}
+
+template <class Type> string typeName();
+template <> string typeName<int>() { return "int"; }
+template <> string typeName<unsigned>() { return "unsigned"; }
+template <> string typeName<long long>() { return "long long"; }
+template <> string typeName<double>() { return "double"; }
+
+// Quote a string for JSON or CSV output.
+string quoted(const string& text){
+    string result = "\"";
+    for(size_t i = 0; i < text.size(); i++){
+        if(text[i] == '"')
+            result += outputFormat == formatJson ? "\\\"" : "\"\"";
+        else
+            result += text[i];
+    }
+    return result + "\"";
+}
+
+// Format a per operation counter, empty when it was not measured.
+string counterText(double value){
+    if(value < 0)
+        return outputFormat == formatJson ? "null" : "";
+    ostringstream text;
+    text << value;
+    return text.str();
+}
+
+void beginReport(){
+    if(outputFormat == formatCsv)
+        cout << "benchmark,method,type,size,distribution,hit_ratio,operations,ns_per_op,mops_per_s,"
+                "cache_misses_per_op,branch_misses_per_op,found,note" << endl;
+    else if(outputFormat == formatJson)
+        cout << "[" << endl;
+    else
+        cout << left << setw(12) << "benchmark" << setw(36) << "method" << setw(10) << "type" << right << setw(11) << "size"
+             << "  " << left << setw(10) << "keys" << right << setw(5) << "hit" << setw(12) << "ns/op" << setw(10) << "Mops/s"
+             << setw(10) << "cache/op" << setw(10) << "branch/op" << setw(10) << "found" << "  note" << endl;
+}
+
+void report(const BenchRecord& record){
+    double nsPerOp = record.totalNs / record.operations;
+    double mopsPerSec = record.operations / record.totalNs * 1000;
+
+    if(outputFormat == formatCsv)
+        cout << quoted(record.benchmark) << "," << quoted(record.method) << "," << quoted(record.type) << "," << record.size << ","
+             << quoted(record.distribution) << "," << record.hitRatio << "," << record.operations << "," << nsPerOp << ","
+             << mopsPerSec << "," << counterText(record.cacheMisses) << "," << counterText(record.branchMisses) << ","
+             << record.found << "," << quoted(record.note) << endl;
+    else if(outputFormat == formatJson)
+        cout << (recordsReported ? ",\n" : "") << "  {\"benchmark\": " << quoted(record.benchmark) << ", \"method\": " << quoted(record.method)
+             << ", \"type\": " << quoted(record.type) << ", \"size\": " << record.size << ", \"distribution\": " << quoted(record.distribution)
+             << ", \"hit_ratio\": " << record.hitRatio << ", \"operations\": " << record.operations << ", \"ns_per_op\": " << nsPerOp
+             << ", \"mops_per_s\": " << mopsPerSec << ", \"cache_misses_per_op\": " << counterText(record.cacheMisses)
+             << ", \"branch_misses_per_op\": " << counterText(record.branchMisses) << ", \"found\": " << record.found
+             << ", \"note\": " << quoted(record.note) << "}" << flush;
+    else
+        cout << left << setw(12) << record.benchmark << setw(36) << record.method << setw(10) << record.type << right << setw(11) << record.size
+             << "  " << left << setw(10) << record.distribution << right << setw(5) << record.hitRatio << setw(12) << setprecision(4) << nsPerOp
+             << setw(10) << mopsPerSec << setw(10) << counterText(record.cacheMisses) << setw(10) << counterText(record.branchMisses)
+             << setw(10) << record.found << "  " << record.note << setprecision(6) << endl;
+    recordsReported++;
+}
+
+void endReport(){
+    if(outputFormat == formatJson)
+        cout << "\n]" << endl;
+}
+
+// Return a record describing a measurement, to be completed by measure().
+BenchRecord makeRecord(const string& benchmark, const string& method, const string& type, size_t size,
+                       const string& distribution, double hitRatio, size_t operations, const string& note = ""){
+    BenchRecord record;
+    record.benchmark = benchmark;
+    record.method = method;
+    record.type = type;
+    record.size = size;
+    record.distribution = distribution;
+    record.hitRatio = hitRatio;
+    record.operations = operations;
+    record.totalNs = 0;
+    record.found = 0;
+    record.cacheMisses = record.branchMisses = -1;
+    record.note = note;
+    return record;
+}
+
+// Time body, which performs record.operations operations and returns how many found something,
+// then report the record.
+template <class Body>
+void measure(BenchRecord record, Body body){
+    perfCounters.start();
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    record.found = body();
+    record.totalNs = elapsedNs(start);
+    perfCounters.stop();
+    if(perfCounters.available()){
+        record.cacheMisses = (double)perfCounters.cacheMisses() / record.operations;
+        record.branchMisses = (double)perfCounters.branchMisses() / record.operations;
+    }
+    report(record);
+}
+
+// Return size sorted keys following the given distribution:
+// "uniform": evenly spread,
+// "zipfian": power law, most keys are small and a few are huge,
+// "clustered": 64 dense groups of keys at evenly spread places.
+// Keys are even, so that a key plus one is never in the array.
+template <class Type>
+vector<Type> sortedKeys(size_t size, const string& distribution){
+    // Largest key before doubling, so that the keys fit in Type.
+    const long long range = sizeof(Type) >= 8 ? 1LL << 40 : 1LL << 29;
+    vector<Type> arr(size);
+    for(size_t i = 0; i < size; i++){
+        long long key;
+        if(distribution == "uniform")
+            key = randomIndex(range);
+        else if(distribution == "zipfian")
+            key = (long long)min((double)range - 1, 1e3 / pow((randomIndex(1 << 30) + 1) / double(1 << 30), 1.2));
+        else
+            key = (long long)(i % 64) * (range / 64) + randomIndex(min((long long)size, range / 64));
+        arr[i] = (Type)(2 * key);
+    }
+    sort(arr.begin(), arr.end());
+    return arr;
+}
+
+// Return count lookup keys for arr: a fraction hitRatio are elements of arr, the rest are missing.
+template <class Type>
+vector<Type> lookupKeys(const vector<Type>& arr, size_t count, double hitRatio){
+    vector<Type> keys(count);
+    for(size_t i = 0; i < count; i++){
+        Type key = arr[randomIndex(arr.size())];
+        keys[i] = randomIndex(1000) < hitRatio * 1000 ? key : key + 1;
+    }
+    return keys;
+}
+
+// Number of lookup keys prepared for each measurement; lookups cycle through them.
+const size_t numKeys = 1 << 16;
+// Number of lookups of each O(log n) measurement.
+const size_t numLookups = 1 << 20;
+
+// Run every SearchingAlgo method over sizes 16 to 2^maxLog2Size, three key distributions
+// and three hit ratios, with elements of type Type.
+template <class Type>
+void benchGrid(int maxLog2Size){
+    SearchingAlgo<Type> objSearch;
+    const string type = typeName<Type>();
+    const char* distributions[] = { "uniform", "zipfian", "clustered" };
+    const double hitRatios[] = { 0.0, 0.5, 1.0 };
+
+    for(int log2Size = 4; log2Size <= maxLog2Size; log2Size += 2){
+        size_t size = (size_t)1 << log2Size;
+        // Linear scans cost O(n) each, so fewer of them are timed on large arrays.
+        size_t scans = max((size_t)4, min(numLookups, ((size_t)1 << 26) / size));
+
+        for(int d = 0; d < 3; d++){
+            vector<Type> arr = sortedKeys<Type>(size, distributions[d]);
+            Type* a = arr.data();
+            int num = size;
+            // Lists are slow to build and to walk, so sublist searches stop at 2^20 nodes.
+            list<Type> largeList;
+            if(log2Size <= 20)
+                largeList.assign(arr.begin(), arr.end());
+
+            for(int h = 0; h < 3; h++){
+                double hitRatio = hitRatios[h];
+                vector<Type> keys = lookupKeys(arr, numKeys, hitRatio);
+                const Type* k = keys.data();
+
+                measure(makeRecord("grid", "binarySearch", type, size, distributions[d], hitRatio, numLookups), [&](){
+                    size_t found = 0;
+                    for(size_t i = 0; i < numLookups; i++)
+                        found += objSearch.binarySearch(a, num, k[i % numKeys]);
+                    return found;
+                });
+                measure(makeRecord("grid", "jumpSearch", type, size, distributions[d], hitRatio, numLookups), [&](){
+                    size_t found = 0;
+                    for(size_t i = 0; i < numLookups; i++)
+                        found += objSearch.jumpSearch(a, num, k[i % numKeys]);
+                    return found;
+                });
+                measure(makeRecord("grid", "interpolationSearch", type, size, distributions[d], hitRatio, numLookups), [&](){
+                    size_t found = 0;
+                    for(size_t i = 0; i < numLookups; i++)
+                        found += objSearch.interpolationSearch(a, num, k[i % numKeys]);
+                    return found;
+                });
+                measure(makeRecord("grid", "exponentialSearch", type, size, distributions[d], hitRatio, numLookups), [&](){
+                    size_t found = 0;
+                    for(size_t i = 0; i < numLookups; i++)
+                        found += objSearch.exponentialSearch(a, num, k[i % numKeys]);
+                    return found;
+                });
+                measure(makeRecord("grid", "fibonacciSearch", type, size, distributions[d], hitRatio, numLookups), [&](){
+                    size_t found = 0;
+                    for(size_t i = 0; i < numLookups; i++)
+                        found += objSearch.fibonacciSearch(a, num, k[i % numKeys]);
+                    return found;
+                });
+                {
+                    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+                    AdaptiveSearch<Type> adaptive(a, size);
+                    ostringstream note;
+                    note << "chose " << searchMethodName(adaptive.method()) << " in " << elapsedNs(start) / 1e6 << " ms";
+                    measure(makeRecord("grid", "AdaptiveSearch", type, size, distributions[d], hitRatio, numLookups, note.str()), [&](){
+                        size_t found = 0;
+                        for(size_t i = 0; i < numLookups; i++)
+                            found += adaptive.search(k[i % numKeys]);
+                        return found;
+                    });
+                }
+                measure(makeRecord("grid", "linearSearch", type, size, distributions[d], hitRatio, scans), [&](){
+                    size_t found = 0;
+                    for(size_t i = 0; i < scans; i++)
+                        found += objSearch.linearSearch(a, num, k[i % numKeys]);
+                    return found;
+                });
+                // Recursion goes one level deeper per element, so keep the stack small.
+                if(log2Size <= 12){
+                    measure(makeRecord("grid", "recursiveLinearSearch", type, size, distributions[d], hitRatio, scans), [&](){
+                        size_t found = 0;
+                        for(size_t i = 0; i < scans; i++)
+                            found += objSearch.recursiveLinearSearch(a, num, k[i % numKeys]);
+                        return found;
+                    });
+                }
+
+                if(log2Size <= 20){
+                    // Patterns of 8 consecutive elements; a miss has its last element changed.
+                    size_t patternCount = max((size_t)4, min((size_t)1024, ((size_t)1 << 22) / size));
+                    vector<list<Type> > patterns(patternCount);
+                    for(size_t p = 0; p < patternCount; p++){
+                        size_t first = randomIndex(size - 8);
+                        patterns[p].assign(arr.begin() + first, arr.begin() + first + 8);
+                        if(randomIndex(1000) >= hitRatio * 1000)
+                            patterns[p].back() += 1;
+                    }
+                    measure(makeRecord("grid", "sublistSearch", type, size, distributions[d], hitRatio, patternCount, "pattern length 8"), [&](){
+                        size_t found = 0;
+                        for(size_t p = 0; p < patternCount; p++)
+                            found += objSearch.sublistSearch(largeList, patterns[p]);
+                        return found;
+                    });
+                    measure(makeRecord("grid", "recursiveSublistSearch", type, size, distributions[d], hitRatio, patternCount, "pattern length 8"), [&](){
+                        size_t found = 0;
+                        for(size_t p = 0; p < patternCount; p++)
+                            found += objSearch.recursiveSublistSearch(largeList, patterns[p]);
+                        return found;
+                    });
+                }
+            }
+        }
+    }
+}
+
+// Compare binarySearchBatch with a loop calling binarySearch once per key.
+void benchBinarySearchBatch(size_t arrSize){
+    SearchingAlgo<int> objSearch;
+    vector<int> arr = sortedKeys<int>(arrSize, "uniform");
+    vector<int> keys = lookupKeys(arr, numLookups, 0.5);
+    vector<SearchResult> results(numLookups);
+
+    measure(makeRecord("batch", "binarySearch", "int", arrSize, "uniform", 0.5, numLookups), [&](){
+        size_t found = 0;
+        for(size_t i = 0; i < numLookups; i++)
+            found += objSearch.binarySearch(arr.data(), arrSize, keys[i]);
+        return found;
+    });
+    measure(makeRecord("batch", "binarySearchBatch", "int", arrSize, "uniform", 0.5, numLookups), [&](){
+        objSearch.binarySearchBatch(arr.data(), arrSize, keys.data(), numLookups, results.data());
+        size_t found = 0;
+        for(size_t i = 0; i < numLookups; i++)
+            found += results[i].found;
+        return found;
+    });
+}
+
+// Compare binarySearch and fibonacciSearch with compareBranching and compareBranchless on random keys.
+void benchBranchless(size_t arrSize, const string& note){
+    vector<int> arr = sortedKeys<int>(arrSize, "uniform");
+    vector<int> keys = lookupKeys(arr, numLookups, 0.5);
+    const CompareMode modes[] = { compareBranching, compareBranchless };
+
+    for(int m = 0; m < 2; m++){
+        SearchingAlgo<int> objSearch(modes[m]);
+        string suffix = modes[m] == compareBranchless ? " (branchless)" : "";
+        measure(makeRecord("branchless", "binarySearch" + suffix, "int", arrSize, "uniform", 0.5, numLookups, note), [&](){
+            size_t found = 0;
+            for(size_t i = 0; i < numLookups; i++)
+                found += objSearch.binarySearch(arr.data(), arrSize, keys[i]);
+            return found;
+        });
+        measure(makeRecord("branchless", "fibonacciSearch" + suffix, "int", arrSize, "uniform", 0.5, numLookups, note), [&](){
+            size_t found = 0;
+            for(size_t i = 0; i < numLookups; i++)
+                found += objSearch.fibonacciSearch(arr.data(), arrSize, keys[i]);
+            return found;
+        });
+    }
+}
+
+// Return count lookup keys for arr whose popularity follows a Zipf law of exponent 1:
+// the key of rank r is looked up with a probability proportional to 1/r, so the hottest 1%
+// of the keys take about 70% of the lookups on a million elements. Ranks are scattered over the
+// array. A fraction hitRatio of the keys are elements of arr, the rest are missing.
+template <class Type>
+vector<Type> zipfianLookupKeys(const vector<Type>& arr, size_t count, double hitRatio){
+    vector<Type> keys(count);
+    uniform_real_distribution<double> unit(0, 1);
+    for(size_t i = 0; i < count; i++){
+        // Inverse of the cumulative distribution, ln(r) / ln(n), of the continuous approximation.
+        size_t rank = (size_t)exp(unit(randomEngine) * log((double)arr.size())) - 1;
+        Type key = arr[(rank * 0x9E3779B1ULL) % arr.size()];
+        keys[i] = (rank % 1000) < hitRatio * 1000 ? key : key + 1;
+    }
+    return keys;
+}
+
+// binarySearch and exponentialSearch on Zipfian lookups, without and with a LookupCache.
+void benchLookupCache(size_t arrSize){
+    vector<long long> arr = sortedKeys<long long>(arrSize, "uniform");
+    vector<long long> keys = zipfianLookupKeys(arr, numLookups, 0.5);
+    const size_t capacities[] = { 0, 1 << 10, 1 << 16 };
+    bool (SearchingAlgo<long long>::*methods[])(long long[], int, const long long&) = {
+        &SearchingAlgo<long long>::binarySearch, &SearchingAlgo<long long>::exponentialSearch
+    };
+    const char* methodNames[] = { "binarySearch", "exponentialSearch" };
+
+    for(int c = 0; c < 3; c++){
+        for(int m = 0; m < 2; m++){
+            SearchingAlgo<long long> objSearch;
+            LookupCache<long long> cache(max(capacities[c], (size_t)1));
+            string method = methodNames[m];
+            string note = "zipfian lookups";
+            if(capacities[c]){
+                objSearch.setLookupCache(&cache);
+                method += " (cache " + to_string(cache.capacity()) + ")";
+                // Untimed run from an empty cache, which the timed run repeats exactly: its hit rate
+                // is the one of the timed run.
+                for(size_t i = 0; i < numLookups; i++)
+                    (objSearch.*methods[m])(arr.data(), arrSize, keys[i]);
+                ostringstream hitRate;
+                hitRate << note << ", hit rate " << fixed << setprecision(3) << cache.hitRate();
+                note = hitRate.str();
+                cache.clear();
+            }
+            measure(makeRecord("cache", method, "long long", arrSize, "uniform", 0.5, numLookups, note), [&](){
+                size_t found = 0;
+                for(size_t i = 0; i < numLookups; i++)
+                    found += (objSearch.*methods[m])(arr.data(), arrSize, keys[i]);
+                return found;
+            });
+        }
+    }
+}
+
+// Return the memory use of filter as a note.
+string filterNote(const BloomFilter<long long>& filter){
+    ostringstream text;
+    text << fixed << setprecision(1) << filter.bitsPerElement() << " bits/element, " << filter.memoryBytes() << " bytes";
+    return text.str();
+}
+
+// binarySearch, jumpSearch and linearSearch with 70% of misses, without and with a BloomFilter
+// of 1% and 0.1% false positive rates. linearSearch runs on the first 4096 elements.
+void benchBloomFilter(size_t arrSize){
+    vector<long long> arr = sortedKeys<long long>(arrSize, "uniform");
+    vector<long long> keys = lookupKeys(arr, numLookups, 0.3);
+    size_t linearSize = min(arrSize, (size_t)4096);
+    vector<long long> linearKeys = lookupKeys(vector<long long>(arr.begin(), arr.begin() + linearSize), numKeys, 0.3);
+    const double rates[] = { 0, 0.01, 0.001 };
+
+    for(int r = 0; r < 3; r++){
+        SearchingAlgo<long long> objSearch;
+        BloomFilter<long long> filter, linearFilter;
+        string suffix, note, linearNote;
+        if(rates[r] > 0){
+            filter.build(arr.data(), arrSize, rates[r]);
+            linearFilter.build(arr.data(), linearSize, rates[r]);
+            ostringstream text;
+            text << " (filter " << rates[r] * 100 << "%)";
+            suffix = text.str();
+            note = filterNote(filter);
+            linearNote = filterNote(linearFilter);
+        }
+
+        objSearch.setBloomFilter(rates[r] > 0 ? &filter : 0);
+        measure(makeRecord("filter", "binarySearch" + suffix, "long long", arrSize, "uniform", 0.3, numLookups, note), [&](){
+            size_t found = 0;
+            for(size_t i = 0; i < numLookups; i++)
+                found += objSearch.binarySearch(arr.data(), arrSize, keys[i]);
+            return found;
+        });
+        measure(makeRecord("filter", "jumpSearch" + suffix, "long long", arrSize, "uniform", 0.3, numKeys, note), [&](){
+            size_t found = 0;
+            for(size_t i = 0; i < numKeys; i++)
+                found += objSearch.jumpSearch(arr.data(), arrSize, keys[i]);
+            return found;
+        });
+        objSearch.setBloomFilter(rates[r] > 0 ? &linearFilter : 0);
+        measure(makeRecord("filter", "linearSearch" + suffix, "long long", linearSize, "uniform", 0.3, numKeys, linearNote), [&](){
+            size_t found = 0;
+            for(size_t i = 0; i < numKeys; i++)
+                found += objSearch.linearSearch(arr.data(), linearSize, linearKeys[i]);
+            return found;
+        });
+    }
+}
+
+#ifdef SEARCHINGALGO_INSTRUMENT
+// Report the statistics of one method as the note of record.
+void reportSearchStats(BenchRecord record, const MethodStats& stats){
+    ostringstream note;
+    note << fixed << setprecision(1) << stats.probesPerCall() << " probes, " << stats.comparisonsPerCall() << " comparisons, "
+         << stats.iterationsPerCall() << " iterations; p50 " << stats.latency.percentile(0.5) << " ns, p99 " << stats.latency.percentile(0.99) << " ns";
+    record.note = note.str();
+    report(record);
+}
+
+// Probes, comparisons and iterations per call, and latency percentiles, of the sorted array
+// searches and of lowerBound with each SearchMethod, on each key distribution. Only built by
+// the Instrumented target.
+void benchSearchStats(size_t arrSize){
+    const char* distributions[] = { "uniform", "zipfian", "clustered" };
+    bool (SearchingAlgo<long long>::*methods[])(long long[], int, const long long&) = {
+        &SearchingAlgo<long long>::binarySearch, &SearchingAlgo<long long>::jumpSearch,
+        &SearchingAlgo<long long>::interpolationSearch, &SearchingAlgo<long long>::exponentialSearch,
+        &SearchingAlgo<long long>::fibonacciSearch
+    };
+    const StatsMethod statsMethods[] = { statsBinary, statsJump, statsInterpolation, statsExponential, statsFibonacci };
+
+    for(int d = 0; d < 3; d++){
+        vector<long long> arr = sortedKeys<long long>(arrSize, distributions[d]);
+        vector<long long> keys = lookupKeys(arr, numKeys, 0.5);
+        for(int m = 0; m < 5; m++){
+            SearchingAlgo<long long> objSearch;
+            BenchRecord record = makeRecord("stats", statsMethodName(statsMethods[m]), "long long", arrSize, distributions[d], 0.5, numKeys);
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            for(size_t i = 0; i < numKeys; i++)
+                record.found += (objSearch.*methods[m])(arr.data(), arrSize, keys[i]);
+            record.totalNs = elapsedNs(start);
+
+            reportSearchStats(record, objSearch.stats().methods[statsMethods[m]]);
+        }
+        const SearchMethod positionMethods[] = { searchBinary, searchJump, searchInterpolation, searchExponential, searchFibonacci };
+        for(int m = 0; m < 5; m++){
+            SearchingAlgo<long long> objSearch;
+            BenchRecord record = makeRecord("stats", string("lowerBound ") + searchMethodName(positionMethods[m]), "long long", arrSize, distributions[d], 0.5, numKeys);
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            for(size_t i = 0; i < numKeys; i++){
+                size_t pos = objSearch.lowerBound(arr.data(), arrSize, keys[i], positionMethods[m]);
+                record.found += pos < arrSize && arr[pos] == keys[i];
+            }
+            record.totalNs = elapsedNs(start);
+            reportSearchStats(record, objSearch.stats().methods[statsLowerBound]);
+        }
+    }
+}
+#endif
+
+// binarySearch and exponentialSearch on the plain array against CompressedArray::search,
+// with the memory used by each.
+void benchCompressedArray(size_t arrSize, const string& distribution){
+    vector<long long> arr = sortedKeys<long long>(arrSize, distribution);
+    vector<long long> keys = lookupKeys(arr, numLookups, 0.5);
+    SearchingAlgo<long long> objSearch;
+    CompressedArray<long long> compressed(arr.data(), arrSize);
+
+    ostringstream plainNote, compressedNote;
+    plainNote << arrSize * sizeof(long long) << " bytes";
+    compressedNote << compressed.memoryBytes() << " bytes, " << fixed << setprecision(2) << compressed.compressionRatio() << "x smaller";
+
+    measure(makeRecord("compressed", "binarySearch", "long long", arrSize, distribution, 0.5, numLookups, plainNote.str()), [&](){
+        size_t found = 0;
+        for(size_t i = 0; i < numLookups; i++)
+            found += objSearch.binarySearch(arr.data(), arrSize, keys[i]);
+        return found;
+    });
+    measure(makeRecord("compressed", "exponentialSearch", "long long", arrSize, distribution, 0.5, numLookups, plainNote.str()), [&](){
+        size_t found = 0;
+        for(size_t i = 0; i < numLookups; i++)
+            found += objSearch.exponentialSearch(arr.data(), arrSize, keys[i]);
+        return found;
+    });
+    measure(makeRecord("compressed", "CompressedArray::search", "long long", arrSize, distribution, 0.5, numLookups, compressedNote.str()), [&](){
+        size_t found = 0;
+        for(size_t i = 0; i < numLookups; i++)
+            found += compressed.search(keys[i]);
+        return found;
+    });
+}
+
+// Range queries of about rangeLength elements: lowerBound and upperBound, then a copy of the
+// range (the way to do it without range queries), against rangeQuery and a sorted rangeQueryBatch.
+void benchRangeQuery(size_t arrSize, size_t rangeLength){
+    SearchingAlgo<long long> objSearch;
+    vector<long long> arr = sortedKeys<long long>(arrSize, "uniform");
+    vector<long long> lows(numKeys), highs(numKeys);
+    for(size_t i = 0; i < numKeys; i++){
+        size_t first = randomIndex(arrSize);
+        lows[i] = arr[first];
+        highs[i] = arr[min(first + rangeLength - 1, arrSize - 1)];
+    }
+    ostringstream note;
+    note << "ranges of " << rangeLength;
+
+    measure(makeRecord("range", "lowerBound+upperBound+copy", "long long", arrSize, "uniform", 1, numKeys, note.str()), [&](){
+        size_t found = 0;
+        vector<long long> copied;
+        for(size_t i = 0; i < numKeys; i++){
+            size_t first = objSearch.lowerBound(arr.data(), arrSize, lows[i]);
+            size_t last = objSearch.upperBound(arr.data(), arrSize, highs[i]);
+            copied.assign(arr.begin() + first, arr.begin() + last);
+            found += copied.size();
+        }
+        return found;
+    });
+    measure(makeRecord("range", "rangeQuery", "long long", arrSize, "uniform", 1, numKeys, note.str()), [&](){
+        size_t found = 0;
+        for(size_t i = 0; i < numKeys; i++)
+            found += objSearch.rangeQuery(arr.data(), arrSize, lows[i], highs[i]).size();
+        return found;
+    });
+
+    // Sort the queries by lo, as a scan over key ranges would issue them.
+    vector<pair<long long, long long> > queries(numKeys);
+    for(size_t i = 0; i < numKeys; i++)
+        queries[i] = make_pair(lows[i], highs[i]);
+    sort(queries.begin(), queries.end());
+    for(size_t i = 0; i < numKeys; i++){
+        lows[i] = queries[i].first;
+        highs[i] = queries[i].second;
+    }
+    vector<RangeView<long long> > results(numKeys);
+    measure(makeRecord("range", "rangeQueryBatch (sorted)", "long long", arrSize, "uniform", 1, numKeys, note.str()), [&](){
+        objSearch.rangeQueryBatch(arr.data(), arrSize, lows.data(), highs.data(), numKeys, results.data());
+        size_t found = 0;
+        for(size_t i = 0; i < numKeys; i++)
+            found += results[i].size();
+        return found;
+    });
+}
+
+// Intersection of a sorted list of largeSize / ratio keys, half of them in the large array, with
+// the large array: one binarySearch per key against each intersectSorted method.
+void benchIntersection(size_t largeSize, size_t ratio){
+    SearchingAlgo<long long> objSearch;
+    vector<long long> large = sortedKeys<long long>(largeSize, "uniform");
+    vector<long long> small = lookupKeys(large, max(largeSize / ratio, (size_t)1), 0.5);
+    sort(small.begin(), small.end());
+    small.erase(unique(small.begin(), small.end()), small.end());
+    vector<long long> out(small.size());
+    ostringstream note;
+    note << "ratio " << ratio << ", " << small.size() << " keys";
+
+    measure(makeRecord("intersect", "binarySearch loop", "long long", largeSize, "uniform", 0.5, small.size(), note.str()), [&](){
+        size_t found = 0;
+        for(size_t i = 0; i < small.size(); i++)
+            found += objSearch.binarySearch(large.data(), largeSize, small[i]);
+        return found;
+    });
+    const IntersectMethod methods[] = { intersectMerge, intersectBlock, intersectGallop, intersectAuto };
+    for(int m = 0; m < 4; m++){
+        string method = string("intersectSorted ") + intersectMethodName(methods[m]);
+        if(methods[m] == intersectAuto)
+            method += string(" (") + intersectMethodName(chooseIntersectMethod(small.size(), largeSize)) + ")";
+        measure(makeRecord("intersect", method, "long long", largeSize, "uniform", 0.5, small.size(), note.str()), [&](){
+            return intersectSorted(small.data(), small.size(), large.data(), largeSize, out.data(), methods[m]);
+        });
+    }
+}
+
+// Record searched in place by its key, through a projection.
+struct KeyedRecord {
+    long long key;
+    long long payload;
+};
+
+// Lower bound on the key of an array of records: a hand-written binary search over the key field
+// against std::ranges::lower_bound and rangeLowerBound with the projection &KeyedRecord::key, whose
+// binary search should compile to the same loop and run within a few percent of it. So should
+// rangeLowerBound on plain keys and with greater<> on descending keys. The comparison is only
+// meaningful on an array that fits in the L2 cache, where the loop, not memory, sets the time.
+// lowerBound on the keys alone, stored apart, is the cost of searching a dense key array instead.
+void benchRangeSearch(size_t arrSize, const string& note){
+    SearchingAlgo<long long> objSearch;
+    vector<long long> keys = sortedKeys<long long>(arrSize, "uniform");
+    vector<KeyedRecord> records(arrSize);
+    for(size_t i = 0; i < arrSize; i++)
+        records[i] = KeyedRecord{keys[i], (long long)i};
+    vector<long long> lookups = lookupKeys(keys, numLookups, 0.5);
+
+    measure(makeRecord("ranges", "hand-written loop", "record", arrSize, "uniform", 0.5, numLookups, note), [&](){
+        size_t found = 0;
+        for(size_t i = 0; i < numLookups; i++){
+            const KeyedRecord* first = records.data();
+            size_t count = arrSize;
+            while(count > 0){
+                size_t half = count / 2;
+                const KeyedRecord* middle = first + half;
+                if(middle->key < lookups[i]){
+                    first = middle + 1;
+                    count -= half + 1;
+                }
+                else
+                    count = half;
+            }
+            found += first != records.data() + arrSize && first->key == lookups[i];
+        }
+        return found;
+    });
+    measure(makeRecord("ranges", "std::ranges::lower_bound", "record", arrSize, "uniform", 0.5, numLookups, note), [&](){
+        size_t found = 0;
+        for(size_t i = 0; i < numLookups; i++){
+            auto pos = ranges::lower_bound(records, lookups[i], {}, &KeyedRecord::key);
+            found += pos != records.end() && pos->key == lookups[i];
+        }
+        return found;
+    });
+    const SearchMethod methods[] = { searchBinary, searchExponential, searchInterpolation };
+    const char* names[] = { "rangeLowerBound binary", "rangeLowerBound exponential", "rangeLowerBound interpolation" };
+    for(int m = 0; m < 3; m++){
+        measure(makeRecord("ranges", names[m], "record", arrSize, "uniform", 0.5, numLookups, note), [&](){
+            size_t found = 0;
+            for(size_t i = 0; i < numLookups; i++){
+                auto pos = rangeLowerBound(records, lookups[i], {}, &KeyedRecord::key, methods[m]);
+                found += pos != records.end() && pos->key == lookups[i];
+            }
+            return found;
+        });
+    }
+    measure(makeRecord("ranges", "rangeLowerBound plain keys", "long long", arrSize, "uniform", 0.5, numLookups, note), [&](){
+        size_t found = 0;
+        for(size_t i = 0; i < numLookups; i++){
+            auto pos = rangeLowerBound(keys, lookups[i]);
+            found += pos != keys.end() && *pos == lookups[i];
+        }
+        return found;
+    });
+    vector<long long> descending(keys.rbegin(), keys.rend());
+    measure(makeRecord("ranges", "rangeLowerBound greater<>", "long long", arrSize, "uniform", 0.5, numLookups, note), [&](){
+        size_t found = 0;
+        for(size_t i = 0; i < numLookups; i++){
+            auto pos = rangeLowerBound(descending, lookups[i], greater<>());
+            found += pos != descending.end() && *pos == lookups[i];
+        }
+        return found;
+    });
+    measure(makeRecord("ranges", "lowerBound on keys", "long long", arrSize, "uniform", 0.5, numLookups, note), [&](){
+        size_t found = 0;
+        for(size_t i = 0; i < numLookups; i++){
+            size_t pos = objSearch.lowerBound(keys.data(), arrSize, lookups[i]);
+            found += pos < arrSize && keys[pos] == lookups[i];
+        }
+        return found;
+    });
+}
+
+// Nearest key lookups of doubles that are not in the array, as readings near stored ones: a scan
+// of the whole array per lookup (for a few lookups only) against nearestSearch with binary and
+// interpolation descents, the SIMD nearestSearchBatch, kNearestSearch and approximateSearch.
+void benchNearestSearch(size_t arrSize){
+    SearchingAlgo<double> objSearch;
+    vector<double> arr = sortedKeys<double>(arrSize, "uniform");
+    vector<double> lookups(numLookups);
+    for(size_t i = 0; i < numLookups; i++)
+        lookups[i] = arr[randomIndex(arrSize)] + (randomIndex(2000) / 1000.0 - 1) * 0.75;
+
+    const size_t numScans = 64;
+    measure(makeRecord("nearest", "linear scan", "double", arrSize, "uniform", 0, numScans), [&](){
+        size_t found = 0;
+        for(size_t i = 0; i < numScans; i++){
+            size_t best = 0;
+            for(size_t j = 1; j < arrSize; j++)
+                best = fabs(arr[j] - lookups[i]) < fabs(arr[best] - lookups[i]) ? j : best;
+            found += fabs(arr[best] - lookups[i]) <= 0.5;
+        }
+        return found;
+    });
+    const SearchMethod methods[] = { searchBinary, searchInterpolation };
+    for(int m = 0; m < 2; m++){
+        measure(makeRecord("nearest", string("nearestSearch ") + searchMethodName(methods[m]), "double", arrSize, "uniform", 0, numLookups), [&](){
+            size_t found = 0;
+            for(size_t i = 0; i < numLookups; i++)
+                found += fabs(arr[objSearch.nearestSearch(arr.data(), arrSize, lookups[i], methods[m])] - lookups[i]) <= 0.5;
+            return found;
+        });
+    }
+    vector<size_t> results(numLookups);
+    measure(makeRecord("nearest", "nearestSearchBatch", "double", arrSize, "uniform", 0, numLookups), [&](){
+        objSearch.nearestSearchBatch(arr.data(), arrSize, lookups.data(), numLookups, results.data());
+        size_t found = 0;
+        for(size_t i = 0; i < numLookups; i++)
+            found += fabs(arr[results[i]] - lookups[i]) <= 0.5;
+        return found;
+    });
+    measure(makeRecord("nearest", "kNearestSearch k=16", "double", arrSize, "uniform", 0, numLookups), [&](){
+        size_t found = 0;
+        for(size_t i = 0; i < numLookups; i++)
+            found += objSearch.kNearestSearch(arr.data(), arrSize, lookups[i], 16).size();
+        return found;
+    });
+    measure(makeRecord("nearest", "approximateSearch 0.5", "double", arrSize, "uniform", 0, numLookups), [&](){
+        size_t found = 0;
+        for(size_t i = 0; i < numLookups; i++)
+            found += objSearch.approximateSearch(arr.data(), arrSize, lookups[i], 0.5);
+        return found;
+    });
+}
+
+// Compare binarySearch with fixedBinarySearch on a table of N elements.
+template <size_t N>
+void benchFixedSearch(){
+    SearchingAlgo<int> objSearch;
+    vector<int> arr = sortedKeys<int>(N, "uniform");
+    vector<int> keys = lookupKeys(arr, numKeys, 0.5);
+    int table[N];
+    copy(arr.begin(), arr.end(), table);
+
+    measure(makeRecord("fixed", "binarySearch", "int", N, "uniform", 0.5, numLookups), [&](){
+        size_t found = 0;
+        for(size_t i = 0; i < numLookups; i++)
+            found += objSearch.binarySearch(table, N, keys[i % numKeys]);
+        return found;
+    });
+    measure(makeRecord("fixed", "fixedBinarySearch", "int", N, "uniform", 0.5, numLookups), [&](){
+        size_t found = 0;
+        for(size_t i = 0; i < numLookups; i++)
+            found += fixedBinarySearch(table, keys[i % numKeys]);
+        return found;
+    });
+}
+
+// Compare binarySearch on the sorted array with EytzingerIndex and BlockedEytzingerIndex.
+void benchEytzinger(size_t arrSize){
+    SearchingAlgo<unsigned> objSearch;
+    vector<unsigned> arr = sortedKeys<unsigned>(arrSize, "uniform");
+    vector<unsigned> keys = lookupKeys(arr, numLookups, 0.5);
+
+    measure(makeRecord("eytzinger", "binarySearch", "unsigned", arrSize, "uniform", 0.5, numLookups), [&](){
+        size_t found = 0;
+        for(size_t i = 0; i < numLookups; i++)
+            found += objSearch.binarySearch(arr.data(), arrSize, keys[i]);
+        return found;
+    });
+    {
+        EytzingerIndex<unsigned> index(arr.data(), arrSize);
+        measure(makeRecord("eytzinger", "EytzingerIndex", "unsigned", arrSize, "uniform", 0.5, numLookups), [&](){
+            size_t found = 0;
+            for(size_t i = 0; i < numLookups; i++)
+                found += index.search(keys[i]);
+            return found;
+        });
+    }
+    {
+        BlockedEytzingerIndex<unsigned> index(arr.data(), arrSize);
+        measure(makeRecord("eytzinger", "BlockedEytzingerIndex", "unsigned", arrSize, "uniform", 0.5, numLookups), [&](){
+            size_t found = 0;
+            for(size_t i = 0; i < numLookups; i++)
+                found += index.search(keys[i]);
+            return found;
+        });
+    }
+}
+
+// Compare linearSearch (vectorized for int) with the plain element-by-element loop on small unsorted arrays.
+void benchLinearSearch(size_t arrSize){
+    SearchingAlgo<int> objSearch;
+    vector<int> arr = sortedKeys<int>(arrSize, "uniform");
+    vector<int> keys = lookupKeys(arr, numKeys, 0.5);
+    shuffle(arr.begin(), arr.end(), randomEngine);
+
+    measure(makeRecord("simd", "plain loop", "int", arrSize, "uniform", 0.5, numLookups), [&](){
+        size_t found = 0;
+        for(size_t i = 0; i < numLookups; i++)
+            found += scalarFind(arr.data(), 0, arrSize, keys[i % numKeys]) < arrSize;
+        return found;
+    });
+    measure(makeRecord("simd", "linearSearch", "int", arrSize, "uniform", 0.5, numLookups), [&](){
+        size_t found = 0;
+        for(size_t i = 0; i < numLookups; i++)
+            found += objSearch.linearSearch(arr.data(), arrSize, keys[i % numKeys]);
+        return found;
+    });
+}
+
+// Scan an array of arrSize elements for a missing key (the worst case) with 1 to numThreads threads.
+void benchParallelSearch(size_t arrSize, unsigned numThreads){
+    vector<int> arr = sortedKeys<int>(arrSize, "uniform");
+    shuffle(arr.begin(), arr.end(), randomEngine);
+
+    // Powers of 2, then numThreads itself.
+    vector<unsigned> threadCounts;
+    for(unsigned threads = 1; threads < numThreads; threads *= 2)
+        threadCounts.push_back(threads);
+    threadCounts.push_back(numThreads);
+
+    for(size_t t = 0; t < threadCounts.size(); t++){
+        ParallelSearch<int> objSearch(threadCounts[t]);
+        ostringstream note;
+        note << "threads=" << threadCounts[t];
+        const size_t lookups = 8;
+
+        measure(makeRecord("parallel", "ParallelSearch::linearSearch", "int", arrSize, "uniform", 0, lookups, note.str()), [&](){
+            size_t found = 0;
+            for(size_t i = 0; i < lookups; i++)
+                found += objSearch.linearSearch(arr.data(), arrSize, 1);
+            return found;
+        });
+        measure(makeRecord("parallel", "ParallelSearch::countMatches", "int", arrSize, "uniform", 1, lookups, note.str()), [&](){
+            size_t found = 0;
+            for(size_t i = 0; i < lookups; i++)
+                found += objSearch.countMatches(arr.data(), arrSize, arr[i]);
+            return found;
+        });
+    }
+}
+
+// Compare binarySearch, interpolationSearch and InterpolationIndex on one key distribution.
+void benchInterpolation(size_t arrSize, const string& distribution){
+    SearchingAlgo<long long> objSearch;
+    vector<long long> arr = sortedKeys<long long>(arrSize, distribution);
+    vector<long long> keys = lookupKeys(arr, numLookups, 0.5);
+
+    measure(makeRecord("interpolate", "binarySearch", "long long", arrSize, distribution, 0.5, numLookups), [&](){
+        size_t found = 0;
+        for(size_t i = 0; i < numLookups; i++)
+            found += objSearch.binarySearch(arr.data(), arrSize, keys[i]);
+        return found;
+    });
+    measure(makeRecord("interpolate", "interpolationSearch", "long long", arrSize, distribution, 0.5, numLookups), [&](){
+        size_t found = 0;
+        for(size_t i = 0; i < numLookups; i++)
+            found += objSearch.interpolationSearch(arr.data(), arrSize, keys[i]);
+        return found;
+    });
+
+    InterpolationIndex<long long> index(arr.data(), arrSize);
+    ostringstream note;
+    note << index.segmentCount() << " segments, max error " << index.maxError();
+    measure(makeRecord("interpolate", "InterpolationIndex", "long long", arrSize, distribution, 0.5, numLookups, note.str()), [&](){
+        size_t found = 0;
+        for(size_t i = 0; i < numLookups; i++)
+            found += index.search(keys[i]);
+        return found;
+    });
+}
+
+// Compare binarySearch with LearnedIndex on a uniform key set.
+// Run with --max-log2 27 (134M keys, 1 GB) to reach the 100M+ key range.
+void benchLearnedIndex(size_t arrSize){
+    SearchingAlgo<long long> objSearch;
+    vector<long long> arr = sortedKeys<long long>(arrSize, "uniform");
+    vector<long long> keys = lookupKeys(arr, numLookups, 0.5);
+
+    measure(makeRecord("learned", "binarySearch", "long long", arrSize, "uniform", 0.5, numLookups), [&](){
+        size_t found = 0;
+        for(size_t i = 0; i < numLookups; i++)
+            found += objSearch.binarySearch(arr.data(), arrSize, keys[i]);
+        return found;
+    });
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    LearnedIndex<long long> index(arr.data(), arrSize);
+    double buildNs = elapsedNs(start);
+
+    ostringstream note;
+    note << index.segmentCount() << " segments, " << index.levelCount() << " levels, "
+         << index.sizeInBytes() << " bytes, built in " << buildNs / 1e6 << " ms";
+    measure(makeRecord("learned", "LearnedIndex", "long long", arrSize, "uniform", 0.5, numLookups, note.str()), [&](){
+        size_t found = 0;
+        for(size_t i = 0; i < numLookups; i++)
+            found += index.search(keys[i]);
+        return found;
+    });
+}
+
+// Compare loading a key file into memory with mapping it, then search the mapping.
+void benchMappedArray(size_t arrSize){
+    const string path = "searchingAlgoBench.keys";
+    vector<long long> arr = sortedKeys<long long>(arrSize, "uniform");
+    vector<long long> keys = lookupKeys(arr, numLookups, 0.5);
+    if(!writeMappedFile(path, arr.data(), arrSize)){
+        cerr << "cannot write " << path << endl;
+        return;
+    }
+
+    measure(makeRecord("mapped", "load into memory", "long long", arrSize, "uniform", 1, 1), [&](){
+        vector<long long> loaded(arrSize);
+        FILE* file = fopen(path.c_str(), "rb");
+        size_t read = file && fseek(file, sizeof(MappedFileHeader), SEEK_SET) == 0 ? fread(loaded.data(), sizeof(long long), arrSize, file) : 0;
+        if(file)
+            fclose(file);
+        return (size_t)(read == arrSize);
+    });
+
+    MappedArray<long long> mapped;
+    measure(makeRecord("mapped", "MappedArray::open", "long long", arrSize, "uniform", 1, 1), [&](){
+        return (size_t)mapped.open(path);
+    });
+
+    const SearchMethod methods[] = { searchBinary, searchExponential, searchInterpolation };
+    for(int m = 0; m < 3; m++){
+        measure(makeRecord("mapped", string("MappedArray::search ") + searchMethodName(methods[m]), "long long", arrSize, "uniform", 0.5, numLookups), [&](){
+            size_t found = 0;
+            for(size_t i = 0; i < numLookups; i++)
+                found += mapped.search(keys[i], methods[m]);
+            return found;
+        });
+    }
+    mapped.close();
+    remove(path.c_str());
+}
+
+// Push a stream of streamSize elements through StreamLinearSearch and StreamSublistSearch
+// in chunks of chunkSize elements. Only one chunk is in memory at a time.
+void benchStreamSearch(size_t streamSize, size_t chunkSize){
+    // Small alphabet so that partial matches are frequent and straddle chunk boundaries.
+    vector<int> chunk(chunkSize);
+    const int pattern[] = { 3, 1, 4, 1, 5 };
+    ostringstream note;
+    note << "chunks of " << chunkSize;
+
+    StreamLinearSearch<int> linear(15);
+    StreamSublistSearch<int> sublist(pattern, pattern + 5);
+    double linearNs = 0, sublistNs = 0;
+    for(size_t pushed = 0; pushed < streamSize; pushed += chunkSize){
+        for(size_t i = 0; i < chunkSize; i++)
+            chunk[i] = randomIndex(16);
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        linear.push(chunk.data(), chunkSize);
+        linearNs += elapsedNs(start);
+        start = chrono::steady_clock::now();
+        sublist.push(chunk.data(), chunkSize);
+        sublistNs += elapsedNs(start);
+    }
+
+    // Chunks are generated between pushes, so the time is added up here rather than by measure().
+    BenchRecord record = makeRecord("stream", "StreamLinearSearch", "int", streamSize, "random", 0, streamSize, note.str());
+    record.totalNs = linearNs;
+    record.found = linear.matchCount();
+    report(record);
+    record = makeRecord("stream", "StreamSublistSearch", "int", streamSize, "random", 0, streamSize, note.str());
+    record.totalNs = sublistNs;
+    record.found = sublist.matchCount();
+    report(record);
+}
+
+// Compare SortedTree with a sorted vector: searches, single inserts, and a batch of updates.
+void benchSortedTree(size_t arrSize){
+    SearchingAlgo<long long> objSearch;
+    vector<long long> arr = sortedKeys<long long>(arrSize, "uniform");
+    vector<long long> keys = lookupKeys(arr, numLookups, 0.5);
+    SortedTree<long long> tree;
+
+    measure(makeRecord("tree", "SortedTree::bulkLoad", "long long", arrSize, "uniform", 1, arrSize), [&](){
+        tree.bulkLoad(arr.data(), arrSize);
+        return tree.size();
+    });
+    measure(makeRecord("tree", "binarySearch", "long long", arrSize, "uniform", 0.5, numLookups), [&](){
+        size_t found = 0;
+        for(size_t i = 0; i < numLookups; i++)
+            found += objSearch.binarySearch(arr.data(), arrSize, keys[i]);
+        return found;
+    });
+    measure(makeRecord("tree", "SortedTree::search", "long long", arrSize, "uniform", 0.5, numLookups), [&](){
+        size_t found = 0;
+        for(size_t i = 0; i < numLookups; i++)
+            found += tree.search(keys[i]);
+        return found;
+    });
+
+    // Odd keys, which are not in the array yet.
+    const size_t numInserts = 1 << 12;
+    measure(makeRecord("tree", "sorted vector insert", "long long", arrSize, "uniform", 0, numInserts), [&](){
+        for(size_t i = 0; i < numInserts; i++)
+            arr.insert(lower_bound(arr.begin(), arr.end(), keys[i] | 1), keys[i] | 1);
+        return arr.size();
+    });
+    measure(makeRecord("tree", "SortedTree::insert", "long long", arrSize, "uniform", 0, numInserts), [&](){
+        for(size_t i = 0; i < numInserts; i++)
+            tree.insert(keys[i] | 1);
+        return tree.size();
+    });
+    measure(makeRecord("tree", "SortedTree::erase", "long long", arrSize, "uniform", 1, numInserts), [&](){
+        size_t erased = 0;
+        for(size_t i = 0; i < numInserts; i++)
+            erased += tree.erase(keys[i] | 1);
+        return erased;
+    });
+
+    // A quarter of the size in inserts and as many erases, merged in one pass.
+    vector<long long> inserts(arrSize / 4), erases(arrSize / 4);
+    for(size_t i = 0; i < inserts.size(); i++){
+        inserts[i] = keys[i % numLookups] | 1;
+        erases[i] = arr[randomIndex(arr.size())];
+    }
+    measure(makeRecord("tree", "SortedTree::applyBatch", "long long", arrSize, "uniform", 1, inserts.size() + erases.size()), [&](){
+        tree.applyBatch(inserts.data(), inserts.size(), erases.data(), erases.size());
+        return tree.size();
+    });
+}
+
+// Read throughput of ConcurrentIndex with 1 to maxThreads reader threads, while a writer
+// publishes a new version every 20 ms.
+void benchConcurrentIndex(size_t arrSize, unsigned maxThreads){
+    vector<long long> arr = sortedKeys<long long>(arrSize, "uniform");
+    vector<long long> keys = lookupKeys(arr, numKeys, 0.5);
+    const size_t lookupsPerThread = 1 << 18;
+
+    for(unsigned threads = 1; threads <= maxThreads; threads *= 2){
+        ConcurrentIndex<long long> index;
+        index.publish(arr.data(), arrSize);
+        atomic<bool> readersDone(false);
+        atomic<size_t> found(0);
+
+        thread writer([&](){
+            while(!readersDone.load()){
+                index.publish(arr.data(), arrSize);
+                this_thread::sleep_for(chrono::milliseconds(20));
+            }
+        });
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        vector<thread> readers;
+        for(unsigned t = 0; t < threads; t++){
+            readers.push_back(thread([&, t](){
+                ConcurrentIndex<long long>::Reader reader = index.reader();
+                size_t hits = 0;
+                for(size_t i = 0; i < lookupsPerThread; i++)
+                    hits += reader.search(keys[(i + t * 7919) % numKeys]);
+                found += hits;
+            }));
+        }
+        for(unsigned t = 0; t < threads; t++)
+            readers[t].join();
+        double totalNs = elapsedNs(start);
+        readersDone = true;
+        writer.join();
+
+        // The counters of measure() only follow the calling thread, so the record is filled here.
+        ostringstream note;
+        note << "threads=" << threads << ", versions=" << index.version();
+        BenchRecord record = makeRecord("concurrent", "ConcurrentIndex::Reader::search", "long long", arrSize, "uniform", 0.5, lookupsPerThread * threads, note.str());
+        record.totalNs = totalNs;
+        record.found = found;
+        report(record);
+    }
+}
+
+// Compare calling sublistSearch once per small list with one multiSublistSearch pass.
+void benchMultiSublistSearch(size_t listSize, size_t numPatterns){
+    SearchingAlgo<int> objSearch;
+
+    // Small alphabet so that partial matches are frequent.
+    list<int> largeList;
+    for(size_t i = 0; i < listSize; i++)
+        largeList.push_back(randomIndex(16));
+
+    vector<list<int> > smallLists(numPatterns);
+    for(size_t p = 0; p < numPatterns; p++){
+        size_t length = 4 + randomIndex(5);
+        for(size_t i = 0; i < length; i++)
+            smallLists[p].push_back(randomIndex(16));
+    }
+
+    ostringstream note;
+    note << numPatterns << " patterns";
+    measure(makeRecord("multi", "sublistSearch loop", "int", listSize, "random", 0, numPatterns, note.str()), [&](){
+        size_t found = 0;
+        for(size_t p = 0; p < numPatterns; p++)
+            found += objSearch.sublistSearch(largeList, smallLists[p]);
+        return found;
+    });
+    measure(makeRecord("multi", "multiSublistSearch", "int", listSize, "random", 0, numPatterns, note.str()), [&](){
+        vector<bool> contained = objSearch.multiSublistSearch(largeList, smallLists);
+        return (size_t)count(contained.begin(), contained.end(), true);
+    });
+}
+
+void benchFeatures(int maxLog2Size){
+    for(int log2Size = 10; log2Size <= min(maxLog2Size, 26); log2Size += 4)
+        benchBinarySearchBatch((size_t)1 << log2Size);
+
+    for(size_t arrSize = 16; arrSize <= 4096; arrSize *= 4)
+        benchLinearSearch(arrSize);
+
+    // Half of the L1 and L2 caches, and 4 times the L3 cache.
+    CacheSizes caches = detectCacheSizes();
+    benchBranchless(caches.l1 / 2 / sizeof(int), "in L1");
+    benchBranchless(caches.l2 / 2 / sizeof(int), "in L2");
+    benchBranchless(min(caches.l3 * 4 / sizeof(int), (size_t)1 << maxLog2Size), "out of cache");
+
+    benchFixedSearch<8>();
+    benchFixedSearch<32>();
+    benchFixedSearch<64>();
+    benchFixedSearch<256>();
+
+    benchParallelSearch((size_t)1 << min(maxLog2Size, 28), max(thread::hardware_concurrency(), 1u));
+
+    benchConcurrentIndex((size_t)1 << min(maxLog2Size, 20), 64);
+
+    benchLookupCache((size_t)1 << min(maxLog2Size, 24));
+
+    benchBloomFilter((size_t)1 << min(maxLog2Size, 24));
+
+    benchCompressedArray((size_t)1 << min(maxLog2Size, 26), "uniform");
+    benchCompressedArray((size_t)1 << min(maxLog2Size, 26), "clustered");
+
+    for(size_t rangeLength = 1; rangeLength <= 4096; rangeLength *= 64)
+        benchRangeQuery((size_t)1 << min(maxLog2Size, 24), rangeLength);
+
+    for(size_t ratio = 1; ratio <= 4096; ratio *= 4)
+        benchIntersection((size_t)1 << min(maxLog2Size, 24), ratio);
+
+    benchRangeSearch((size_t)1 << min(maxLog2Size, 14), "fits in L2");
+    benchRangeSearch((size_t)1 << min(maxLog2Size, 24), "");
+
+    benchNearestSearch((size_t)1 << min(maxLog2Size, 24));
+
+#ifdef SEARCHINGALGO_INSTRUMENT
+    benchSearchStats((size_t)1 << min(maxLog2Size, 24));
+#endif
+
+    benchInterpolation((size_t)1 << min(maxLog2Size, 24), "uniform");
+    benchInterpolation((size_t)1 << min(maxLog2Size, 24), "zipfian");
+    benchInterpolation((size_t)1 << min(maxLog2Size, 24), "clustered");
+
+    for(int log2Size = 20; log2Size <= min(maxLog2Size, 27); log2Size += 3)
+        benchLearnedIndex((size_t)1 << log2Size);
+
+    benchMappedArray((size_t)1 << min(maxLog2Size, 26));
+
+    benchSortedTree((size_t)1 << min(maxLog2Size, 24));
+
+    benchStreamSearch((size_t)1 << min(maxLog2Size, 26), 1 << 16);
+
+    benchMultiSublistSearch(1 << 18, 100);
+    benchMultiSublistSearch(1 << 18, 1000);
+
+    // 1K, 32K, 1M, 32M and 1G elements.
+    for(int log2Size = 10; log2Size <= maxLog2Size; log2Size += 5)
+        benchEytzinger((size_t)1 << log2Size);
+}
+
+int main(int argc, char* argv[])
+{
+    int maxLog2Size = 22;
+    string suite = "all";
+
+    for(int i = 1; i < argc; i++){
+        string option = argv[i];
+        if(option == "--format" && i + 1 < argc){
+            string format = argv[++i];
+            outputFormat = format == "csv" ? formatCsv : format == "json" ? formatJson : formatText;
+        }
+        else if(option == "--suite" && i + 1 < argc)
+            suite = argv[++i];
+        else if(option == "--max-log2" && i + 1 < argc)
+            maxLog2Size = atoi(argv[++i]);
+        else if(!option.empty() && isdigit((unsigned char)option[0]))
+            maxLog2Size = atoi(option.c_str());
+        else{
+            cerr << "Usage: " << argv[0] << " [--suite grid|features|all] [--format text|csv|json] [--max-log2 N]" << endl;
+            return 1;
+        }
+    }
+    maxLog2Size = max(4, min(maxLog2Size, 30));
+
+    beginReport();
+    if(suite == "grid" || suite == "all"){
+        benchGrid<int>(maxLog2Size);
+        benchGrid<long long>(maxLog2Size);
+        benchGrid<double>(maxLog2Size);
+    }
+    if(suite == "features" || suite == "all")
+        benchFeatures(maxLog2Size);
+    endReport();
+
+    return 0;
+}
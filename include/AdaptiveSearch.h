@@ -0,0 +1,366 @@
+#ifndef ADAPTIVESEARCH_H
+#define ADAPTIVESEARCH_H
+
+#include <SearchingAlgo.h>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <chrono>
+#include <cstdint>
+#include <type_traits>
+#ifdef __linux__
+#include <unistd.h>
+#endif
+using namespace std;
+
+// Sizes of the data caches of the machine in bytes.
+struct CacheSizes {
+    size_t l1, l2, l3;
+};
+
+// Return the data cache sizes reported by the system, or typical sizes where it cannot tell.
+inline CacheSizes detectCacheSizes(){
+    CacheSizes caches = { 32 << 10, 1 << 20, 8 << 20 };
+#if defined(__linux__) && defined(_SC_LEVEL1_DCACHE_SIZE)
+    long size = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+    if(size > 0)
+        caches.l1 = size;
+    size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    if(size > 0)
+        caches.l2 = size;
+    size = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    if(size > 0)
+        caches.l3 = size;
+#endif
+    return caches;
+}
+
+// Front-end of the SearchingAlgo sorted array methods that picks the method itself.
+// When built, it samples the array - its size against the cache sizes and, for arithmetic
+// types, how evenly the keys are spread - to rule out the methods that cannot win, then times
+// the remaining ones and sends every lookup to the fastest.
+// The methods are timed on recent lookups of the workload, passed to record(), since the keys
+// looked up decide the path of each method: where interpolation and exponential search probe
+// depends on where the keys fall, misses between keys end elsewhere than hits, and hot keys keep
+// their probe paths in the cache. The window of recorded lookups is completed with keys of the
+// array and, for arithmetic types, keys between them.
+// Call update() whenever the array changes or moves: it calibrates again if enough of the
+// sampled keys differ. method(), calibratedNs() and explanation() tell which method was chosen
+// and why. The selector keeps a pointer to the array, which must not change or move between
+// updates. The const methods may be called from several threads at once; record(), update()
+// and calibrate() may not run at the same time as any other call.
+template <class Type>
+class AdaptiveSearch {
+    public:
+        // Number of lookups timed for each candidate method, per calibration round.
+        static const size_t calibrationLookups = 2048;
+        static const size_t defaultSampleCount = 64;
+
+        // Sample and calibrate on arrListSorted (num elements, sorted ascending).
+        // sampleCount: keys sampled at evenly spaced positions, to measure the spread and detect
+        // changes (at least 2).
+        // queryWindow: number of recorded lookups kept to calibrate on, rounded up to a power of 2;
+        // 0 keeps none, and the methods are timed on keys generated from the array only.
+        // recalibrationThreshold: fraction of the sampled keys that must differ for update() to
+        // calibrate again; 0 calibrates again on any change.
+        AdaptiveSearch(const Type arrListSorted[], size_t num, size_t sampleCount = defaultSampleCount,
+                       size_t queryWindow = calibrationLookups, double recalibrationThreshold = 0);
+
+        // Take the new contents of the array. Calibrate again if the pointer or the size changed,
+        // or if more than recalibrationThreshold of the sampled keys differ from those of the last
+        // calibration. Return true if it calibrated again.
+        bool update(const Type arrListSorted[], size_t num);
+
+        // Sample and time the methods again, e.g. after the load of the machine or the workload
+        // changed.
+        void calibrate();
+
+        // Add item to the window of recent lookups that calibrate() times the methods on,
+        // replacing the oldest once the window is full. Recording every lookup, or a sample of
+        // them, is up to the caller.
+        void record(const Type& item);
+
+        // Return the index of the first element not less than item, or num if there is none.
+        size_t lowerBound(const Type& item) const;
+
+        // Return true if item is in the array.
+        bool search(const Type& item) const;
+
+        // Method every lookup is sent to.
+        SearchMethod method() const { return chosen; }
+
+        // Average time of one lookup with method during the last calibration in nanoseconds,
+        // or a negative value if it was ruled out without timing.
+        double calibratedNs(SearchMethod method) const { return nsPerLookup[method]; }
+
+        // Largest distance between a sampled position and its position if the keys were evenly
+        // spread from the first to the last, as a fraction of the size: 0 for evenly spread keys.
+        // 1 for types that cannot be interpolated.
+        double spreadError() const { return spread; }
+
+        // One line saying which method was chosen and why, for logs and dashboards.
+        string explanation() const;
+
+    private:
+        static const size_t numMethods = searchJump + 1;
+        // A method replaces the best one so far only if it is faster by more than this fraction,
+        // so that timing noise does not make the choice flip between close methods.
+        static const double switchMargin;
+
+        // Keys at sampleCount evenly spaced positions.
+        vector<Type> sampleKeys() const;
+
+        // calibrationLookups keys to time the methods on: the recorded lookups, most recent first,
+        // then keys of the array at pseudo-random positions alternating with keys between them.
+        vector<Type> calibrationKeys() const;
+
+        // A key between low and high (low <= high), missing from the array unless they are
+        // neighbours; low for types that are not arithmetic.
+        static Type keyBetween(const Type& low, const Type& high, integral_constant<int, 2>);
+        static Type keyBetween(const Type& low, const Type& high, integral_constant<int, 1>);
+        static Type keyBetween(const Type& low, const Type& high, integral_constant<int, 0>);
+
+        // Measure spreadError() of the array.
+        double measureSpread(true_type) const;
+        double measureSpread(false_type) const { return 1; }
+
+        // Return the reason not to time method, or an empty string if it is a candidate.
+        string ruleOut(SearchMethod method) const;
+
+        // Time method on keys and return the average nanoseconds per lookup.
+        double timeLookups(SearchMethod method, const vector<Type>& keys) const;
+
+        const Type* arr;
+        size_t num;
+        size_t sampleCount;
+        double recalibrationThreshold;
+        CacheSizes caches;
+        vector<Type> samples;
+        // Ring buffer of the last recorded lookups, of a power of 2 size, and the number recorded.
+        vector<Type> recentQueries;
+        size_t queryCount;
+        double spread;
+        SearchMethod chosen;
+        double nsPerLookup[numMethods];
+        string ruledOut[numMethods];
+        // Results of the timed lookups, kept so that the compiler cannot drop them.
+        mutable size_t sink;
+        // SearchingAlgo methods are not const.
+        mutable SearchingAlgo<Type> searcher;
+};
+
+template <class Type>
+const size_t AdaptiveSearch<Type>::calibrationLookups;
+
+template <class Type>
+const size_t AdaptiveSearch<Type>::defaultSampleCount;
+
+template <class Type>
+const size_t AdaptiveSearch<Type>::numMethods;
+
+template <class Type>
+const double AdaptiveSearch<Type>::switchMargin = 0.05;
+
+template <class Type>
+AdaptiveSearch<Type>::AdaptiveSearch(const Type arrListSorted[], size_t num, size_t sampleCount, size_t queryWindow, double recalibrationThreshold)
+    : arr(arrListSorted), num(num), sampleCount(max(sampleCount, (size_t)2)), recalibrationThreshold(recalibrationThreshold),
+      caches(detectCacheSizes()), queryCount(0), sink(0){
+    if(queryWindow > 0){
+        size_t size = 1;
+        while(size < queryWindow)
+            size *= 2;
+        recentQueries.resize(size);
+    }
+    calibrate();
+}
+
+template <class Type>
+bool AdaptiveSearch<Type>::update(const Type arrListSorted[], size_t num){
+    if(arrListSorted == arr && num == this->num){
+        vector<Type> keys = sampleKeys();
+        size_t changed = 0;
+        for(size_t i = 0; i < keys.size(); i++)
+            changed += !(keys[i] == samples[i]);
+        if(changed <= recalibrationThreshold * keys.size())
+            return false;
+    }
+    arr = arrListSorted;
+    this->num = num;
+    calibrate();
+    return true;
+}
+
+template <class Type>
+vector<Type> AdaptiveSearch<Type>::sampleKeys() const{
+    vector<Type> keys;
+    if(num == 0)
+        return keys;
+    for(size_t i = 0; i < sampleCount; i++)
+        keys.push_back(arr[(num - 1) * i / (sampleCount - 1)]);
+    return keys;
+}
+
+template <class Type>
+vector<Type> AdaptiveSearch<Type>::calibrationKeys() const{
+    vector<Type> keys;
+    keys.reserve(calibrationLookups);
+    size_t recorded = min(queryCount, recentQueries.size());
+    for(size_t i = 0; i < recorded && keys.size() < calibrationLookups; i++)
+        keys.push_back(recentQueries[(queryCount - 1 - i) & (recentQueries.size() - 1)]);
+
+    // Pseudo-random positions (xorshift), the same for every calibration of the same size.
+    uint64_t state = 0x9E3779B97F4A7C15ULL ^ num;
+    while(keys.size() < calibrationLookups){
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        size_t position = state % num;
+        if(keys.size() % 2 == 0 || position + 1 == num)
+            keys.push_back(arr[position]);
+        else
+            keys.push_back(keyBetween(arr[position], arr[position + 1], integral_constant<int, is_integral<Type>::value ? 2 : is_floating_point<Type>::value ? 1 : 0>()));
+    }
+    return keys;
+}
+
+template <class Type>
+Type AdaptiveSearch<Type>::keyBetween(const Type& low, const Type& high, integral_constant<int, 2>){
+    // Halves first, so that the sum does not overflow.
+    return (Type)(low / 2 + high / 2 + (low % 2 + high % 2) / 2);
+}
+
+template <class Type>
+Type AdaptiveSearch<Type>::keyBetween(const Type& low, const Type& high, integral_constant<int, 1>){
+    return low / 2 + high / 2;
+}
+
+template <class Type>
+Type AdaptiveSearch<Type>::keyBetween(const Type& low, const Type&, integral_constant<int, 0>){
+    return low;
+}
+
+template <class Type>
+double AdaptiveSearch<Type>::measureSpread(true_type) const{
+    if(num < 2)
+        return 0;
+    double low = (double)arr[0];
+    double range = (double)arr[num - 1] - low;
+    // All keys equal: no position can be predicted.
+    if(!(range > 0))
+        return 1;
+    double error = 0;
+    for(size_t i = 0; i < sampleCount; i++){
+        size_t position = (num - 1) * i / (sampleCount - 1);
+        double expected = ((double)arr[position] - low) / range * (num - 1);
+        error = max(error, fabs(expected - (double)position));
+    }
+    return error / num;
+}
+
+template <class Type>
+string AdaptiveSearch<Type>::ruleOut(SearchMethod method) const{
+    ostringstream reason;
+    size_t bytes = num * sizeof(Type);
+    if(method == searchInterpolation && !is_arithmetic<Type>::value)
+        reason << "the type cannot be interpolated";
+    else if(method == searchInterpolation && spread > 0.1)
+        reason << "keys too unevenly spread (error " << spread << ")";
+    // O(sqrt n) probes only pay off while every probe hits the L1 cache.
+    else if(method == searchJump && bytes > caches.l1)
+        reason << "larger than the L1 cache (" << caches.l1 << " bytes)";
+    return reason.str();
+}
+
+template <class Type>
+double AdaptiveSearch<Type>::timeLookups(SearchMethod method, const vector<Type>& keys) const{
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    size_t total = 0;
+    for(size_t i = 0; i < keys.size(); i++)
+        total += searcher.lowerBound(arr, num, keys[i], method);
+    double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+    sink += total;
+    return ns / keys.size();
+}
+
+template <class Type>
+void AdaptiveSearch<Type>::calibrate(){
+    samples = sampleKeys();
+    chosen = searchBinary;
+    for(size_t m = 0; m < numMethods; m++){
+        nsPerLookup[m] = -1;
+        ruledOut[m].clear();
+    }
+    if(num < 2){
+        spread = 0;
+        for(size_t m = 0; m < numMethods; m++)
+            ruledOut[m] = "too few elements";
+        return;
+    }
+    spread = measureSpread(is_arithmetic<Type>());
+
+    // The same keys for every method.
+    vector<Type> keys = calibrationKeys();
+
+    // Two rounds, keeping the faster one, so that the first round warms the caches.
+    for(size_t m = 0; m < numMethods; m++){
+        SearchMethod method = (SearchMethod)m;
+        ruledOut[m] = ruleOut(method);
+        if(ruledOut[m].empty())
+            nsPerLookup[m] = timeLookups(method, keys);
+    }
+    for(size_t m = 0; m < numMethods; m++){
+        if(nsPerLookup[m] >= 0)
+            nsPerLookup[m] = min(nsPerLookup[m], timeLookups((SearchMethod)m, keys));
+    }
+
+    for(size_t m = 0; m < numMethods; m++){
+        if(nsPerLookup[m] >= 0 && nsPerLookup[m] < nsPerLookup[chosen] * (1 - switchMargin))
+            chosen = (SearchMethod)m;
+    }
+}
+
+template <class Type>
+void AdaptiveSearch<Type>::record(const Type& item){
+    if(recentQueries.empty())
+        return;
+    recentQueries[queryCount & (recentQueries.size() - 1)] = item;
+    queryCount++;
+}
+
+template <class Type>
+size_t AdaptiveSearch<Type>::lowerBound(const Type& item) const{
+    return searcher.lowerBound(arr, num, item, chosen);
+}
+
+template <class Type>
+bool AdaptiveSearch<Type>::search(const Type& item) const{
+    size_t pos = lowerBound(item);
+    return pos < num && !(item < arr[pos]);
+}
+
+template <class Type>
+string AdaptiveSearch<Type>::explanation() const{
+    ostringstream text;
+    size_t bytes = num * sizeof(Type);
+    text << searchMethodName(chosen) << " search for " << num << " elements (" << bytes << " bytes, ";
+    if(bytes <= caches.l1)
+        text << "fits in L1";
+    else if(bytes <= caches.l2)
+        text << "fits in L2";
+    else if(bytes <= caches.l3)
+        text << "fits in L3";
+    else
+        text << "larger than L3";
+    text << "), spread error " << spread << ";";
+    for(size_t m = 0; m < numMethods; m++){
+        text << " " << searchMethodName((SearchMethod)m) << ": ";
+        if(nsPerLookup[m] >= 0)
+            text << nsPerLookup[m] << " ns";
+        else
+            text << "not timed, " << ruledOut[m];
+        text << (m + 1 < numMethods ? "," : "");
+    }
+    return text.str();
+}
+
+#endif // ADAPTIVESEARCH_H
@@ -0,0 +1,136 @@
+#ifndef BLOOMFILTER_H
+#define BLOOMFILTER_H
+
+#include <SearchHash.h>
+#include <vector>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+using namespace std;
+
+// Approximate membership filter built from the elements of an array, to answer most lookups of
+// missing keys without searching the array. Attach it to a SearchingAlgo instance with
+// setBloomFilter(); the searches of the array it was built from then return false at once for
+// the keys the filter rejects.
+// mayContain() never returns false for an element of the array; for a missing key it returns
+// true with a probability close to the false positive rate given to build().
+// Blocked Bloom filter: the bits of a key all lie in one 64 byte block chosen by its hash, so a
+// query reads a single cache line. This needs 10% more bits than a classic Bloom filter for the
+// same false positive rate, and more below 0.1%.
+// The filter does not see changes to the array: build it again after modifying the array.
+// Type needs std::hash<Type> (see searchHash()); without it every key is a candidate.
+template <class Type>
+class BloomFilter {
+    public:
+        // Empty filter, attached to no array.
+        BloomFilter();
+
+        // Build the filter for arr (num elements); see build().
+        BloomFilter(const Type arr[], size_t num, double falsePositiveRate = 0.01);
+
+        // Build the filter for arr (num elements, in any order), replacing the previous contents.
+        // falsePositiveRate: target rate of missing keys accepted by mayContain(), in (0, 1).
+        // Memory: about 1.6 * log2(1 / falsePositiveRate) bits per element, e.g. 10.5 bits for 1%.
+        // Time complexity: O(n)
+        void build(const Type arr[], size_t num, double falsePositiveRate = 0.01);
+
+        // Return false if item is certainly not in the array, true if it may be.
+        // Time complexity: O(1), one cache line read.
+        bool mayContain(const Type& item) const;
+
+        // Return true if the filter was built for arr (num elements) and item is not in it.
+        bool rejects(const Type arr[], size_t num, const Type& item) const { return arr == array && num == count && !mayContain(item); }
+
+        // Size of the bit array in bytes.
+        size_t memoryBytes() const { return blocks.size() * sizeof(Block); }
+        double bitsPerElement() const { return count ? 8.0 * memoryBytes() / count : 0; }
+        // Number of bits set per element.
+        int hashCount() const { return numHashes; }
+        double falsePositiveRate() const { return targetRate; }
+
+    private:
+        struct alignas(64) Block {
+            uint64_t words[8];
+        };
+
+        static uint64_t hashOf(const Type& item);
+
+        // Return the position in its block of bit k of a key, k = 0, 1, 2...
+        // bits: hash of the key, scrambled as bits are drawn from its top 63 bits, 9 at a time.
+        static unsigned nextBit(uint64_t& bits, int k){
+            if(k % 7 == 0)
+                bits *= 0x9E3779B97F4A7C15ULL;
+            return bits >> (55 - 9 * (k % 7)) & 511;
+        }
+
+        vector<Block> blocks;
+        int numHashes;
+        double targetRate;
+        const Type* array;
+        size_t count;
+};
+
+template <class Type>
+BloomFilter<Type>::BloomFilter() : numHashes(0), targetRate(0), array(0), count(0){
+}
+
+template <class Type>
+BloomFilter<Type>::BloomFilter(const Type arr[], size_t num, double falsePositiveRate){
+    build(arr, num, falsePositiveRate);
+}
+
+template <class Type>
+uint64_t BloomFilter<Type>::hashOf(const Type& item){
+    // 64-bit finalizer of MurmurHash3, since std::hash of integers is often the identity.
+    uint64_t h = searchHash(item);
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+template <class Type>
+void BloomFilter<Type>::build(const Type arr[], size_t num, double falsePositiveRate){
+    targetRate = min(max(falsePositiveRate, 1e-9), 0.5);
+    array = arr;
+    count = num;
+
+    // A classic Bloom filter needs log2(1/p) / ln 2 bits per element and ln 2 bits per element
+    // hashes for a rate p. Blocking raises the rate, the more so as p is low: 10% more bits make
+    // up for it down to 0.1%, and 10% more again for every decade below.
+    double bitsPerKey = log2(1 / targetRate) / log(2.0);
+    numHashes = max(1, min(16, (int)lround(bitsPerKey * log(2.0))));
+    double blockingFactor = 1.1 + 0.1 * max(0.0, log10(1 / targetRate) - 3);
+    size_t numBlocks = max((size_t)1, (size_t)ceil(num * bitsPerKey * blockingFactor / 512));
+    blocks.assign(numBlocks, Block());
+
+    for(size_t i = 0; i < num; i++){
+        uint64_t h = hashOf(arr[i]);
+        Block& block = blocks[((h >> 32) * blocks.size()) >> 32];
+        uint64_t bits = h;
+        for(int k = 0; k < numHashes; k++){
+            unsigned bit = nextBit(bits, k);
+            block.words[bit / 64] |= (uint64_t)1 << (bit % 64);
+        }
+    }
+}
+
+template <class Type>
+bool BloomFilter<Type>::mayContain(const Type& item) const{
+    if(blocks.empty())
+        return true;
+    uint64_t h = hashOf(item);
+    const Block& block = blocks[((h >> 32) * blocks.size()) >> 32];
+    uint64_t bits = h;
+    for(int k = 0; k < numHashes; k++){
+        unsigned bit = nextBit(bits, k);
+        if(!(block.words[bit / 64] >> (bit % 64) & 1))
+            return false;
+    }
+    return true;
+}
+
+#endif // BLOOMFILTER_H
@@ -0,0 +1,190 @@
+#ifndef COMPRESSEDARRAY_H
+#define COMPRESSEDARRAY_H
+
+#include <SearchingAlgo.h>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+using namespace std;
+
+// Sorted array of integers stored compressed, and searched without decompressing it.
+// The elements are cut into blocks of blockSize. The first element of each block, its head, is
+// kept as is in a small array; the others are stored as their difference with the head (frame
+// of reference), bit-packed with just the number of bits the largest difference of the block
+// needs. A lookup binary searches the heads, then binary searches the packed differences of one
+// block, reading each one in place: a search touches the heads and a few cache lines of a block.
+// Dense keys compress best: n keys spread over a range of R values take about log2(128 R / n)
+// bits each, plus about 1 bit each for the heads and the block metadata, instead of
+// sizeof(Type) * 8.
+// Type must be an integral type.
+template <class Type>
+class CompressedArray {
+    public:
+        static const size_t blockSize = 128;
+
+        CompressedArray() : num(0) {}
+        CompressedArray(const Type arrListSorted[], size_t num) { build(arrListSorted, num); }
+
+        // Compress arrListSorted (num elements, sorted ascending), replacing the previous contents.
+        // Time complexity: O(n)
+        void build(const Type arrListSorted[], size_t num);
+
+        size_t size() const { return num; }
+        bool empty() const { return num == 0; }
+
+        // Return element i.
+        Type at(size_t i) const;
+
+        // Decompress the count elements starting at first into out.
+        void decode(size_t first, size_t count, Type out[]) const;
+
+        // Return the index of the first element not less than item, or size() if there is none.
+        // method: how the heads are searched (searchBinary, searchInterpolation...).
+        // Time complexity: O(log(n / blockSize) + log(blockSize))
+        size_t lowerBound(const Type& item, SearchMethod method = searchBinary) const;
+
+        // Return true if item is in the array.
+        bool search(const Type& item, SearchMethod method = searchBinary) const;
+
+        // Bytes used by the heads, the packed blocks and their metadata.
+        size_t memoryBytes() const;
+        // Size of the uncompressed array divided by memoryBytes().
+        double compressionRatio() const { return num ? (double)num * sizeof(Type) / memoryBytes() : 0; }
+
+    private:
+        static_assert(is_integral<Type>::value, "CompressedArray needs an integral type");
+
+        typedef typename make_unsigned<Type>::type Unsigned;
+
+        // Difference number i (bits of width bits each) of the block starting at word first.
+        uint64_t packed(size_t first, size_t i, unsigned width) const;
+
+        // Number of elements of block b.
+        size_t blockLength(size_t b) const { return min(blockSize, num - b * blockSize); }
+
+        // Number of packed differences of block b less than delta.
+        size_t countLess(size_t b, uint64_t delta) const;
+
+        size_t num;
+        vector<Type> heads;
+        // Index in words of the first word of each block.
+        vector<uint64_t> offsets;
+        // Bits per difference of each block, 0 when all its elements are equal.
+        vector<uint8_t> widths;
+        // Packed differences, plus one word of padding so that a read can always take two words.
+        vector<uint64_t> words;
+        // SearchingAlgo methods are not const.
+        mutable SearchingAlgo<Type> searcher;
+};
+
+template <class Type>
+const size_t CompressedArray<Type>::blockSize;
+
+template <class Type>
+void CompressedArray<Type>::build(const Type arrListSorted[], size_t num){
+    this->num = num;
+    size_t numBlocks = (num + blockSize - 1) / blockSize;
+    heads.resize(numBlocks);
+    offsets.resize(numBlocks);
+    widths.resize(numBlocks);
+    words.clear();
+
+    for(size_t b = 0; b < numBlocks; b++){
+        const Type* block = arrListSorted + b * blockSize;
+        size_t length = blockLength(b);
+        heads[b] = block[0];
+        // The largest difference is the one of the last element.
+        uint64_t largest = (Unsigned)((Unsigned)block[length - 1] - (Unsigned)block[0]);
+        unsigned width = 0;
+        while(width < 64 && (largest >> width))
+            width++;
+        widths[b] = width;
+        offsets[b] = words.size();
+
+        words.resize(words.size() + (length * width + 63) / 64, 0);
+        uint64_t* blockWords = words.data() + offsets[b];
+        for(size_t i = 0; i < length && width > 0; i++){
+            uint64_t delta = (Unsigned)((Unsigned)block[i] - (Unsigned)block[0]);
+            size_t bit = i * width;
+            blockWords[bit / 64] |= delta << (bit % 64);
+            if(bit % 64 + width > 64)
+                blockWords[bit / 64 + 1] |= delta >> (64 - bit % 64);
+        }
+    }
+    words.push_back(0);
+    words.shrink_to_fit();
+}
+
+template <class Type>
+inline uint64_t CompressedArray<Type>::packed(size_t first, size_t i, unsigned width) const{
+    size_t bit = i * width;
+    const uint64_t* word = &words[first + bit / 64];
+    unsigned shift = bit % 64;
+    // The second word supplies the high bits of a difference that straddles two words; shifting
+    // it in two steps keeps the shift below 64 when shift is 0.
+    uint64_t value = (word[0] >> shift) | ((word[1] << 1) << (63 - shift));
+    return width == 64 ? value : value & (((uint64_t)1 << width) - 1);
+}
+
+template <class Type>
+Type CompressedArray<Type>::at(size_t i) const{
+    size_t b = i / blockSize;
+    if(widths[b] == 0)
+        return heads[b];
+    return (Type)((Unsigned)heads[b] + (Unsigned)packed(offsets[b], i % blockSize, widths[b]));
+}
+
+template <class Type>
+void CompressedArray<Type>::decode(size_t first, size_t count, Type out[]) const{
+    for(size_t i = first; i < first + count; ){
+        size_t b = i / blockSize;
+        size_t end = min(first + count, b * blockSize + blockLength(b));
+        Unsigned head = heads[b];
+        unsigned width = widths[b];
+        for(; i < end; i++)
+            *out++ = width ? (Type)(head + (Unsigned)packed(offsets[b], i % blockSize, width)) : (Type)head;
+    }
+}
+
+template <class Type>
+size_t CompressedArray<Type>::countLess(size_t b, uint64_t delta) const{
+    unsigned width = widths[b];
+    size_t length = blockLength(b);
+    if(width < 64 && delta > ((uint64_t)1 << width) - 1)
+        return length;
+    // Branchless binary search, as SearchingAlgo::branchlessBinarySearch does: base is the last
+    // difference less than delta among the length ones from base, if there is one.
+    size_t base = 0;
+    while(length > 1){
+        size_t half = length / 2;
+        base = packed(offsets[b], base + half, width) < delta ? base + half : base;
+        length -= half;
+    }
+    return base + (packed(offsets[b], base, width) < delta);
+}
+
+template <class Type>
+size_t CompressedArray<Type>::lowerBound(const Type& item, SearchMethod method) const{
+    // Blocks before the first head not less than item, j, end with elements less than item, except
+    // maybe block j - 1, where the lower bound is if it is not the head of block j.
+    size_t j = searcher.lowerBound(heads.data(), heads.size(), item, method);
+    if(j == 0)
+        return 0;
+    size_t b = j - 1;
+    size_t count = widths[b] == 0 ? blockLength(b) : countLess(b, (Unsigned)((Unsigned)item - (Unsigned)heads[b]));
+    return b * blockSize + count;
+}
+
+template <class Type>
+bool CompressedArray<Type>::search(const Type& item, SearchMethod method) const{
+    size_t pos = lowerBound(item, method);
+    return pos < num && at(pos) == item;
+}
+
+template <class Type>
+size_t CompressedArray<Type>::memoryBytes() const{
+    return heads.size() * (sizeof(Type) + sizeof(uint64_t) + sizeof(uint8_t)) + words.size() * sizeof(uint64_t);
+}
+
+#endif // COMPRESSEDARRAY_H
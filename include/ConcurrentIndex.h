@@ -0,0 +1,232 @@
+#ifndef CONCURRENTINDEX_H
+#define CONCURRENTINDEX_H
+
+#include <SearchingAlgo.h>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <cstdint>
+#include <cstddef>
+using namespace std;
+
+// Sorted array shared by many reader threads and replaced from time to time by a writer.
+// Readers never block: a search reads the current version through an atomic pointer.
+// The writer builds the new version aside, publishes it with one atomic exchange, and frees
+// the old version only once no reader can still be using it (epoch-based reclamation):
+// - a global epoch is advanced at every publish;
+// - a reader announces the epoch it started in, in its own slot, for the duration of a search;
+// - a version retired at epoch e is freed once no slot announces an epoch <= e.
+// Readers hold a slot through a Reader object, one per thread, taken with reader().
+template <class Type>
+class ConcurrentIndex {
+    private:
+        struct Version {
+            vector<Type> elements;
+            uint64_t number;
+        };
+
+        // Epoch announced by one reader, 0 when it is not searching.
+        // Slots are cache line aligned so that readers do not slow each other down.
+        struct alignas(64) ReaderSlot {
+            atomic<uint64_t> epoch;
+            atomic<bool> taken;
+        };
+
+    public:
+        // Handle of one reader thread on the index. Not to be shared between threads, nor used
+        // re-entrantly from inside read().
+        class Reader {
+            public:
+                Reader(Reader&& other) : index(other.index), slot(other.slot) { other.slot = 0; }
+                ~Reader();
+
+                // Return true if item is in the current version.
+                bool search(const Type& item);
+
+                // Return the index of the first element not less than item in the current version.
+                size_t lowerBound(const Type& item, SearchMethod method = searchBinary);
+
+                // Call visit(elements, num, versionNumber) on the current version. The version
+                // stays valid, and unchanged, until visit returns.
+                // visit must not use this Reader again (read, search or lowerBound): the nested
+                // call would overwrite the epoch announced by this one, and reset it to 0 when it
+                // returns, letting the writer free the version visit is still reading.
+                // Take another Reader for nested searches.
+                template <class Visitor>
+                void read(Visitor visit);
+
+            private:
+                friend class ConcurrentIndex;
+                Reader(ConcurrentIndex* index, ReaderSlot* slot) : index(index), slot(slot) {}
+                Reader(const Reader&);
+                Reader& operator=(const Reader&);
+
+                ConcurrentIndex* index;
+                ReaderSlot* slot;
+                SearchingAlgo<Type> searcher;
+        };
+
+        // maxReaders: number of Reader objects that can exist at the same time.
+        explicit ConcurrentIndex(size_t maxReaders = 256);
+        // No Reader may outlive the index.
+        ~ConcurrentIndex();
+
+        // Return a reader for the calling thread. Waits if maxReaders readers exist.
+        Reader reader();
+
+        // Publish a copy of arrListSorted (num elements, sorted ascending) as the new version.
+        // Readers see either the old version or the new one, never a mix.
+        // Versions no reader can see any more are freed.
+        void publish(const Type arrListSorted[], size_t num);
+        void publish(vector<Type>&& sortedElements);
+
+        // Free the retired versions no reader can see any more. Return how many are left.
+        size_t reclaim();
+
+        // Number of the current version: 0 before the first publish.
+        uint64_t version() const { return latestNumber.load(); }
+
+    private:
+        ConcurrentIndex(const ConcurrentIndex&);
+        ConcurrentIndex& operator=(const ConcurrentIndex&);
+
+        // Announce the current epoch in slot and return the current version.
+        const Version* enter(ReaderSlot* slot);
+        void leave(ReaderSlot* slot) { slot->epoch.store(0, memory_order_release); }
+
+        // reclaim() with the writer mutex held.
+        size_t reclaimRetired();
+
+        struct RetiredVersion {
+            Version* version;
+            uint64_t epoch;
+        };
+
+        atomic<Version*> current;
+        atomic<uint64_t> epoch;
+        atomic<uint64_t> latestNumber;
+        vector<ReaderSlot> slots;
+        // Serializes writers.
+        mutex writerMutex;
+        vector<RetiredVersion> retired;
+};
+
+template <class Type>
+ConcurrentIndex<Type>::ConcurrentIndex(size_t maxReaders) : epoch(1), latestNumber(0), slots(maxReaders > 0 ? maxReaders : 1){
+    Version* empty = new Version;
+    empty->number = 0;
+    current.store(empty);
+    for(size_t i = 0; i < slots.size(); i++){
+        slots[i].epoch.store(0);
+        slots[i].taken.store(false);
+    }
+}
+
+template <class Type>
+ConcurrentIndex<Type>::~ConcurrentIndex(){
+    for(size_t i = 0; i < retired.size(); i++)
+        delete retired[i].version;
+    delete current.load();
+}
+
+template <class Type>
+typename ConcurrentIndex<Type>::Reader ConcurrentIndex<Type>::reader(){
+    while(true){
+        for(size_t i = 0; i < slots.size(); i++){
+            bool expected = false;
+            if(!slots[i].taken.load(memory_order_relaxed) && slots[i].taken.compare_exchange_strong(expected, true))
+                return Reader(this, &slots[i]);
+        }
+        this_thread::yield();
+    }
+}
+
+template <class Type>
+const typename ConcurrentIndex<Type>::Version* ConcurrentIndex<Type>::enter(ReaderSlot* slot){
+    // The announcement must be visible before the version pointer is read (both sequentially
+    // consistent), so that a writer retiring this version sees the announcement.
+    slot->epoch.store(epoch.load());
+    return current.load();
+}
+
+template <class Type>
+void ConcurrentIndex<Type>::publish(const Type arrListSorted[], size_t num){
+    publish(vector<Type>(arrListSorted, arrListSorted + num));
+}
+
+template <class Type>
+void ConcurrentIndex<Type>::publish(vector<Type>&& sortedElements){
+    lock_guard<mutex> lock(writerMutex);
+    Version* next = new Version;
+    next->elements.swap(sortedElements);
+    next->number = current.load()->number + 1;
+
+    Version* previous = current.exchange(next);
+    // Readers that got previous announced an epoch no later than this one; readers entering
+    // from now on see the new epoch, and the new version.
+    RetiredVersion entry = { previous, epoch.fetch_add(1) };
+    retired.push_back(entry);
+    latestNumber.store(next->number);
+    // Free what can be freed without waiting.
+    reclaimRetired();
+}
+
+template <class Type>
+size_t ConcurrentIndex<Type>::reclaim(){
+    lock_guard<mutex> lock(writerMutex);
+    return reclaimRetired();
+}
+
+template <class Type>
+size_t ConcurrentIndex<Type>::reclaimRetired(){
+    uint64_t oldest = UINT64_MAX;
+    for(size_t i = 0; i < slots.size(); i++){
+        uint64_t announced = slots[i].epoch.load();
+        if(announced != 0 && announced < oldest)
+            oldest = announced;
+    }
+    size_t kept = 0;
+    for(size_t i = 0; i < retired.size(); i++){
+        if(retired[i].epoch < oldest)
+            delete retired[i].version;
+        else
+            retired[kept++] = retired[i];
+    }
+    retired.resize(kept);
+    return kept;
+}
+
+template <class Type>
+ConcurrentIndex<Type>::Reader::~Reader(){
+    if(slot)
+        slot->taken.store(false, memory_order_release);
+}
+
+template <class Type>
+template <class Visitor>
+void ConcurrentIndex<Type>::Reader::read(Visitor visit){
+    const Version* version = index->enter(slot);
+    visit(version->elements.data(), version->elements.size(), version->number);
+    index->leave(slot);
+}
+
+template <class Type>
+bool ConcurrentIndex<Type>::Reader::search(const Type& item){
+    const Version* version = index->enter(slot);
+    size_t num = version->elements.size();
+    size_t pos = searcher.lowerBound(version->elements.data(), num, item);
+    bool found = pos < num && !(item < version->elements[pos]);
+    index->leave(slot);
+    return found;
+}
+
+template <class Type>
+size_t ConcurrentIndex<Type>::Reader::lowerBound(const Type& item, SearchMethod method){
+    const Version* version = index->enter(slot);
+    size_t pos = searcher.lowerBound(version->elements.data(), version->elements.size(), item, method);
+    index->leave(slot);
+    return pos;
+}
+
+#endif // CONCURRENTINDEX_H
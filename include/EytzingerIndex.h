@@ -0,0 +1,210 @@
+#ifndef EYTZINGERINDEX_H
+#define EYTZINGERINDEX_H
+
+#include <SearchingAlgo.h>
+#include <vector>
+using namespace std;
+
+// Build-once search index over a sorted array, stored in Eytzinger (BFS) order.
+// The root is at index 1 and the children of node k are at 2k and 2k+1, so the first
+// levels of the tree share a few cache lines and every step of the search moves forward in memory.
+// It gives the same answers as SearchingAlgo::binarySearch on the original array.
+// Memory: one copy of the elements plus one position per element.
+template <class Type>
+class EytzingerIndex {
+    public:
+        // Copy arrListSorted (num elements, sorted ascending) into Eytzinger order.
+        // Time complexity: O(n)
+        EytzingerIndex(const Type arrListSorted[], size_t num);
+
+        // Return the index in the original sorted array of the first element not less than item,
+        // or the number of elements if there is none.
+        // The descent is branchless and prefetches the four grandchildren of each visited node.
+        // Time complexity: O(log n)
+        size_t lowerBound(const Type& item) const;
+
+        // Return true if item is in the index.
+        bool search(const Type& item) const;
+
+        size_t size() const { return num; }
+
+    private:
+        size_t build(const Type arrListSorted[], size_t i, size_t k);
+        // Return the node holding the lower bound of item, 0 if there is none.
+        size_t lowerBoundNode(const Type& item) const;
+
+        size_t num;
+        // Elements in Eytzinger order, index 0 is unused.
+        vector<Type> tree;
+        // Position of each node in the original sorted array.
+        vector<size_t> position;
+};
+
+// Build-once search index over a sorted array, stored as an implicit B-tree (S-tree).
+// Each node holds as many keys as fit in one 64 byte cache line and is aligned to it, padded to
+// a whole number of cache lines when the size of Type does not divide 64, so a lookup touches
+// one cache line per level and the number of levels is log_(B+1) n.
+// The last node is padded with copies of the largest element.
+template <class Type>
+class BlockedEytzingerIndex {
+    public:
+        // Number of keys in each node.
+        static const size_t blockSize = sizeof(Type) >= 64 ? 1 : 64 / sizeof(Type);
+
+        // Copy arrListSorted (num elements, sorted ascending) into B-tree order.
+        // Time complexity: O(n)
+        BlockedEytzingerIndex(const Type arrListSorted[], size_t num);
+
+        // Return the index in the original sorted array of the first element not less than item,
+        // or the number of elements if there is none.
+        // Time complexity: O(B log_B n)
+        size_t lowerBound(const Type& item) const;
+
+        // Return true if item is in the index.
+        bool search(const Type& item) const;
+
+        size_t size() const { return num; }
+
+    private:
+        // One node. Its alignment rounds its size up to a multiple of 64 bytes, so every node of
+        // a vector of blocks starts a cache line.
+        struct alignas(64) Block {
+            Type keys[blockSize];
+        };
+
+        void build(const Type arrListSorted[], size_t& t, size_t k);
+        // Return the slot holding the lower bound of item, or numBlocks * blockSize if there is none.
+        size_t lowerBoundSlot(const Type& item) const;
+        // Index of the i-th child of node k.
+        static size_t child(size_t k, size_t i) { return k * (blockSize + 1) + i + 1; }
+
+        size_t num;
+        size_t numBlocks;
+        vector<Block> blocks;
+        // Position of each key in the original sorted array, num for padding.
+        vector<size_t> position;
+};
+
+template <class Type>
+EytzingerIndex<Type>::EytzingerIndex(const Type arrListSorted[], size_t num)
+    : num(num), tree(num + 1), position(num + 1){
+    if(num > 0){
+        build(arrListSorted, 0, 1);
+        // tree[0] is never compared, but position[0] is returned when item is greater than every element.
+        position[0] = num;
+    }
+}
+
+template <class Type>
+size_t EytzingerIndex<Type>::build(const Type arrListSorted[], size_t i, size_t k){
+    // In-order traversal of the implicit tree assigns the sorted elements in ascending order.
+    if(k <= num){
+        i = build(arrListSorted, i, 2 * k);
+        tree[k] = arrListSorted[i];
+        position[k] = i;
+        i++;
+        i = build(arrListSorted, i, 2 * k + 1);
+    }
+    return i;
+}
+
+template <class Type>
+size_t EytzingerIndex<Type>::lowerBoundNode(const Type& item) const{
+    const Type* t = tree.data();
+    size_t k = 1;
+    while(k <= num){
+        // Grandchildren 4k..4k+3 are adjacent, one prefetch covers them.
+        searchPrefetch(t + 4 * k);
+        // Go right if the node is less than item, left otherwise.
+        k = 2 * k + (t[k] < item);
+    }
+
+    // The path ends with a run of right turns after the last left turn, which was taken
+    // at the answer. Shift out the trailing ones and the left turn to get back to it.
+#if defined(__GNUC__) || defined(__clang__)
+    k >>= __builtin_ctzll(~(unsigned long long)k) + 1;
+#else
+    while(k & 1)
+        k >>= 1;
+    k >>= 1;
+#endif
+    return k;
+}
+
+template <class Type>
+size_t EytzingerIndex<Type>::lowerBound(const Type& item) const{
+    if(num == 0)
+        return 0;
+    return position[lowerBoundNode(item)];
+}
+
+template <class Type>
+bool EytzingerIndex<Type>::search(const Type& item) const{
+    if(num == 0)
+        return false;
+    size_t k = lowerBoundNode(item);
+    return k != 0 && !(item < tree[k]);
+}
+
+template <class Type>
+BlockedEytzingerIndex<Type>::BlockedEytzingerIndex(const Type arrListSorted[], size_t num)
+    : num(num), numBlocks((num + blockSize - 1) / blockSize), blocks(numBlocks){
+    position.assign(numBlocks * blockSize, num);
+
+    if(num > 0){
+        size_t t = 0;
+        build(arrListSorted, t, 0);
+    }
+}
+
+template <class Type>
+void BlockedEytzingerIndex<Type>::build(const Type arrListSorted[], size_t& t, size_t k){
+    // In-order traversal: child i, then key i of the node, ..., then the last child.
+    if(k < numBlocks){
+        for(size_t i = 0; i < blockSize; i++){
+            build(arrListSorted, t, child(k, i));
+            if(t < num){
+                blocks[k].keys[i] = arrListSorted[t];
+                position[k * blockSize + i] = t;
+                t++;
+            }
+            else
+                blocks[k].keys[i] = arrListSorted[num - 1];
+        }
+        build(arrListSorted, t, child(k, blockSize));
+    }
+}
+
+template <class Type>
+size_t BlockedEytzingerIndex<Type>::lowerBoundSlot(const Type& item) const{
+    size_t slot = numBlocks * blockSize;
+    size_t k = 0;
+    while(k < numBlocks){
+        const Type* node = blocks[k].keys;
+        // Count the keys less than item. The loop has no early exit, so it can be vectorized.
+        size_t i = 0;
+        for(size_t j = 0; j < blockSize; j++)
+            i += (node[j] < item);
+        // Key i is the first key of this node not less than item, and it comes before
+        // every candidate found higher up in the tree.
+        if(i < blockSize)
+            slot = k * blockSize + i;
+        k = child(k, i);
+    }
+    return slot;
+}
+
+template <class Type>
+size_t BlockedEytzingerIndex<Type>::lowerBound(const Type& item) const{
+    size_t slot = lowerBoundSlot(item);
+    return slot < numBlocks * blockSize ? position[slot] : num;
+}
+
+template <class Type>
+bool BlockedEytzingerIndex<Type>::search(const Type& item) const{
+    size_t slot = lowerBoundSlot(item);
+    // Padding slots have position num and never count as a match.
+    return slot < numBlocks * blockSize && position[slot] < num && !(item < blocks[slot / blockSize].keys[slot % blockSize]);
+}
+
+#endif // EYTZINGERINDEX_H
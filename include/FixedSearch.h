@@ -0,0 +1,88 @@
+#ifndef FIXEDSEARCH_H
+#define FIXEDSEARCH_H
+
+#include <cstddef>
+#include <type_traits>
+using namespace std;
+
+// Searches of sorted arrays whose size N is known at compile time, e.g. small static tables.
+// The size is a template parameter, so the searches have no loop control left:
+// - up to fixedScanLimit elements, every element is compared with the key and the results
+//   are added up; the compiler turns this into a few SIMD compares and additions.
+// - above it, a binary search that always takes the same number of steps, each step being a
+//   single compare and conditional move, with no branch to mispredict.
+// All functions are constexpr, so searches of constexpr tables can be done at compile time.
+// Requires C++14.
+
+// Largest N searched by comparing every element.
+const size_t fixedScanLimit = 32;
+
+// Branchless binary search step over the Length elements starting at arr[base].
+template <size_t Length>
+struct FixedSearchStep {
+    template <class Type>
+    static constexpr size_t lowerBound(const Type* arr, size_t base, const Type& item){
+        // The first element not less than item is in [base, base + Length]. Halve the range
+        // without a branch: the compiler emits a conditional move for the choice of base.
+        return FixedSearchStep<Length - Length / 2>::lowerBound(arr, arr[base + Length / 2] < item ? base + Length / 2 : base, item);
+    }
+};
+
+template <>
+struct FixedSearchStep<1> {
+    template <class Type>
+    static constexpr size_t lowerBound(const Type* arr, size_t base, const Type& item){
+        return base + (arr[base] < item);
+    }
+};
+
+template <>
+struct FixedSearchStep<0> {
+    template <class Type>
+    static constexpr size_t lowerBound(const Type*, size_t base, const Type&){
+        return base;
+    }
+};
+
+// Number of elements of arr less than item, compared all at once.
+template <size_t N, class Type>
+constexpr size_t fixedLowerBound(const Type* arr, const Type& item, true_type){
+    size_t count = 0;
+    for(size_t i = 0; i < N; i++)
+        count += arr[i] < item;
+    return count;
+}
+
+template <size_t N, class Type>
+constexpr size_t fixedLowerBound(const Type* arr, const Type& item, false_type){
+    return FixedSearchStep<N>::lowerBound(arr, 0, item);
+}
+
+// Return the index of the first of the N elements of arrListSorted that is not less than item,
+// or N if there is none.
+// Time complexity: O(log N) compares without branches, or N compares in SIMD registers for N <= fixedScanLimit.
+template <size_t N, class Type>
+constexpr size_t fixedLowerBound(const Type* arrListSorted, const Type& item){
+    return fixedLowerBound<N>(arrListSorted, item, integral_constant<bool, (N <= fixedScanLimit)>());
+}
+
+template <size_t N, class Type>
+constexpr size_t fixedLowerBound(const Type (&arrListSorted)[N], const Type& item){
+    return fixedLowerBound<N>(&arrListSorted[0], item);
+}
+
+// Return true if item is one of the N elements of arrListSorted.
+template <size_t N, class Type>
+constexpr bool fixedBinarySearch(const Type (&arrListSorted)[N], const Type& item){
+    size_t pos = fixedLowerBound(arrListSorted, item);
+    return pos < N && !(item < arrListSorted[pos]);
+}
+
+// Return the index of item in arrListSorted (its first occurrence), or N if it is not there.
+template <size_t N, class Type>
+constexpr size_t fixedFindPosition(const Type (&arrListSorted)[N], const Type& item){
+    size_t pos = fixedLowerBound(arrListSorted, item);
+    return pos < N && !(item < arrListSorted[pos]) ? pos : N;
+}
+
+#endif // FIXEDSEARCH_H
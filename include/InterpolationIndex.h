@@ -0,0 +1,161 @@
+#ifndef INTERPOLATIONINDEX_H
+#define INTERPOLATIONINDEX_H
+
+#include <SearchingAlgo.h>
+#include <vector>
+#include <type_traits>
+using namespace std;
+
+// Linear-model interpolation over a sorted array of arithmetic values.
+// The array is cut into segments of equal length, and each segment stores the slope and
+// intercept of the least squares line through its (value, position) points, plus the largest
+// distance between a predicted and a real position. A lookup picks the segment, predicts the
+// position and searches only the window allowed by the error bound.
+// The index keeps a pointer to the array, which must not change or move while the index is used.
+template <class Type>
+class InterpolationIndex {
+    static_assert(is_arithmetic<Type>::value, "InterpolationIndex needs an arithmetic Type");
+
+    public:
+        // Fit the models of arrListSorted (num elements, sorted ascending).
+        // segmentSize: number of elements covered by each linear model.
+        // Time complexity: O(n)
+        InterpolationIndex(const Type arrListSorted[], size_t num, size_t segmentSize = 256);
+
+        // Return the index of the first element not less than item, or num if there is none.
+        // Time complexity: O(log(n / segmentSize) + log(error))
+        size_t lowerBound(const Type& item) const;
+
+        // Return true if item is in the array.
+        bool search(const Type& item) const;
+
+        // Number of segments, and the largest prediction error of any segment.
+        size_t segmentCount() const { return segments.size(); }
+        size_t maxError() const;
+
+    private:
+        struct Segment {
+            // First element and position range [start, end) covered by the model.
+            size_t start, end;
+            double slope, intercept;
+            // Largest distance of a real position below and above its prediction.
+            size_t errorBelow, errorAbove;
+        };
+
+        const Type* arr;
+        size_t num;
+        vector<Segment> segments;
+        // First value of each segment, searched to pick the segment.
+        vector<Type> firstValues;
+};
+
+template <class Type>
+InterpolationIndex<Type>::InterpolationIndex(const Type arrListSorted[], size_t num, size_t segmentSize)
+    : arr(arrListSorted), num(num){
+    if(segmentSize == 0)
+        segmentSize = 1;
+
+    for(size_t start = 0; start < num; start += segmentSize){
+        Segment segment;
+        segment.start = start;
+        segment.end = min(start + segmentSize, num);
+        size_t count = segment.end - start;
+
+        // Least squares fit of position against value. Values are taken relative to the first
+        // value of the segment to keep the sums accurate.
+        double base = (double)arr[start];
+        double sumX = 0, sumY = 0, sumXX = 0, sumXY = 0;
+        for(size_t i = start; i < segment.end; i++){
+            double x = (double)arr[i] - base;
+            double y = (double)(i - start);
+            sumX += x;
+            sumY += y;
+            sumXX += x * x;
+            sumXY += x * y;
+        }
+        double denominator = count * sumXX - sumX * sumX;
+        // All values equal: every prediction is the start of the segment.
+        segment.slope = denominator > 0 ? (count * sumXY - sumX * sumY) / denominator : 0;
+        if(segment.slope < 0)
+            segment.slope = 0;
+        segment.intercept = (sumY - segment.slope * sumX) / count - segment.slope * base + start;
+
+        // Record the error bounds of the fitted model.
+        segment.errorBelow = segment.errorAbove = 0;
+        segments.push_back(segment);
+        firstValues.push_back(arr[start]);
+        Segment& fitted = segments.back();
+        for(size_t i = start; i < fitted.end; i++){
+            size_t predicted = 0;
+            double estimate = fitted.intercept + fitted.slope * (double)arr[i];
+            if(estimate > (double)fitted.start)
+                predicted = estimate < (double)(fitted.end - 1) ? (size_t)estimate : fitted.end - 1;
+            else
+                predicted = fitted.start;
+            if(predicted > i)
+                fitted.errorBelow = max(fitted.errorBelow, predicted - i);
+            else
+                fitted.errorAbove = max(fitted.errorAbove, i - predicted);
+        }
+    }
+}
+
+template <class Type>
+size_t InterpolationIndex<Type>::lowerBound(const Type& item) const{
+    if(num == 0 || !(arr[0] < item))
+        return 0;
+
+    // Last segment whose first value is less than item. The answer is after its start
+    // and at most the start of the next segment, whose first value is not less than item.
+    size_t s = 0, last = firstValues.size();
+    while(s + 1 < last){
+        size_t middle = s + (last - s) / 2;
+        if(firstValues[middle] < item)
+            s = middle;
+        else
+            last = middle;
+    }
+    const Segment& segment = segments[s];
+    size_t segmentEnd = segment.end;
+
+    // Predict the position and clamp it into the segment.
+    double estimate = segment.intercept + segment.slope * (double)item;
+    size_t predicted = segment.start;
+    if(estimate > (double)segment.start)
+        predicted = estimate < (double)(segmentEnd - 1) ? (size_t)estimate : segmentEnd - 1;
+
+    // Window allowed by the error bounds. The model is monotonic, so a value between two
+    // elements is predicted between their predictions.
+    size_t first = predicted > segment.start + segment.errorAbove + 1 ? predicted - segment.errorAbove - 1 : segment.start;
+    size_t windowEnd = min(predicted + segment.errorBelow + 1, segmentEnd);
+
+    // Check that the window holds the answer, else search the whole segment.
+    if((first > segment.start && !(arr[first - 1] < item)) || (windowEnd < segmentEnd && arr[windowEnd] < item)){
+        first = segment.start;
+        windowEnd = segmentEnd;
+    }
+    while(first < windowEnd){
+        size_t middle = first + (windowEnd - first) / 2;
+        if(arr[middle] < item)
+            first = middle + 1;
+        else
+            windowEnd = middle;
+    }
+    return first;
+}
+
+template <class Type>
+bool InterpolationIndex<Type>::search(const Type& item) const{
+    size_t pos = lowerBound(item);
+    return pos < num && !(item < arr[pos]);
+}
+
+template <class Type>
+size_t InterpolationIndex<Type>::maxError() const{
+    size_t error = 0;
+    for(size_t s = 0; s < segments.size(); s++)
+        error = max(error, max(segments[s].errorBelow, segments[s].errorAbove));
+    return error;
+}
+
+#endif // INTERPOLATIONINDEX_H
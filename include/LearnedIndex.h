@@ -0,0 +1,209 @@
+#ifndef LEARNEDINDEX_H
+#define LEARNEDINDEX_H
+
+#include <SearchingAlgo.h>
+#include <vector>
+#include <type_traits>
+using namespace std;
+
+// Learned index over a static sorted array of arithmetic values, in the style of the PGM-index.
+// The positions of the keys are approximated by a piecewise linear function in which every
+// segment predicts the position of each of its keys within +/- epsilon. Segments are found in a
+// single pass with the shrinking cone method, and the first keys of the segments are indexed
+// the same way, level by level, until one segment is left.
+// A lookup walks the levels from the top, each time searching only a window of 2*epsilon + 1
+// entries around the prediction, and ends with a bounded binary search in the array.
+// The index keeps a pointer to the array, which must not change or move while the index is used.
+template <class Type>
+class LearnedIndex {
+    static_assert(is_arithmetic<Type>::value, "LearnedIndex needs an arithmetic Type");
+
+    public:
+        // Error bound of the upper levels.
+        static const size_t levelEpsilon = 4;
+
+        // Build the index of arrListSorted (num elements, sorted ascending).
+        // epsilon: largest distance between the predicted and the real position of a key.
+        // Time complexity: O(n)
+        LearnedIndex(const Type arrListSorted[], size_t num, size_t epsilon = 64);
+
+        // Return the index of the first element not less than item, or num if there is none.
+        // Time complexity: O(log epsilon) per level.
+        size_t lowerBound(const Type& item) const;
+
+        // Return true if item is in the array.
+        bool search(const Type& item) const;
+
+        // Number of segments in the bottom level, number of levels, and memory used by the model.
+        size_t segmentCount() const { return levels.empty() ? 0 : levels[0].size(); }
+        size_t levelCount() const { return levels.size(); }
+        size_t sizeInBytes() const;
+
+    private:
+        struct Segment {
+            // First key covered by the segment and its position in the level below.
+            Type key;
+            size_t position;
+            double slope;
+        };
+
+        // Distance from low to high (high >= low) as a double, exact for integers up to 2^53.
+        static double keyDistance(const Type& high, const Type& low, true_type){ return (double)((unsigned long long)high - (unsigned long long)low); }
+        static double keyDistance(const Type& high, const Type& low, false_type){ return (double)high - (double)low; }
+        static double keyDistance(const Type& high, const Type& low){ return keyDistance(high, low, is_integral<Type>()); }
+
+        // Append to segments the piecewise linear model of the points (keys[i], positions[i]).
+        static void buildLevel(const vector<Type>& keys, const vector<size_t>& positions, size_t epsilon, vector<Segment>& segments);
+
+        // Predict the position of item from segment s of a level whose segments cover positions up to end.
+        static size_t predict(const vector<Segment>& segments, size_t s, const Type& item, size_t end);
+
+        const Type* arr;
+        size_t num;
+        size_t epsilon;
+        // levels[0] models the array, levels[l + 1] models the first keys of levels[l].
+        vector<vector<Segment> > levels;
+        // Searches of the final window. SearchingAlgo methods are not const.
+        mutable SearchingAlgo<Type> searcher;
+};
+
+template <class Type>
+LearnedIndex<Type>::LearnedIndex(const Type arrListSorted[], size_t num, size_t epsilon)
+    : arr(arrListSorted), num(num), epsilon(epsilon){
+    if(num == 0)
+        return;
+
+    // Only the first position of each distinct key is modelled, since that is the lower bound.
+    vector<Type> keys;
+    vector<size_t> positions;
+    for(size_t i = 0; i < num; i++){
+        if(i == 0 || arr[i - 1] < arr[i]){
+            keys.push_back(arr[i]);
+            positions.push_back(i);
+        }
+    }
+
+    levels.push_back(vector<Segment>());
+    buildLevel(keys, positions, epsilon, levels.back());
+
+    // Index the first keys of the level below until a single segment is left.
+    while(levels.back().size() > 1){
+        const vector<Segment>& below = levels.back();
+        keys.clear();
+        positions.clear();
+        for(size_t s = 0; s < below.size(); s++){
+            keys.push_back(below[s].key);
+            positions.push_back(s);
+        }
+        vector<Segment> level;
+        buildLevel(keys, positions, levelEpsilon, level);
+        levels.push_back(level);
+    }
+}
+
+template <class Type>
+void LearnedIndex<Type>::buildLevel(const vector<Type>& keys, const vector<size_t>& positions, size_t epsilon, vector<Segment>& segments){
+    size_t start = 0;
+    while(start < keys.size()){
+        // Range of slopes of the lines through the first point that keep every point
+        // seen so far within epsilon. The range shrinks with every point added.
+        double minSlope = 0, maxSlope = -1;
+        size_t i = start + 1;
+        for(; i < keys.size(); i++){
+            double dx = keyDistance(keys[i], keys[start]);
+            double dy = (double)positions[i] - (double)positions[start];
+            double low = (dy - epsilon) / dx;
+            double high = (dy + epsilon) / dx;
+            if(maxSlope < 0){
+                minSlope = max(low, 0.0);
+                maxSlope = high;
+            }
+            else{
+                if(max(minSlope, low) > min(maxSlope, high))
+                    break;
+                minSlope = max(minSlope, low);
+                maxSlope = min(maxSlope, high);
+            }
+        }
+
+        Segment segment;
+        segment.key = keys[start];
+        segment.position = positions[start];
+        segment.slope = maxSlope < 0 ? 0 : (minSlope + maxSlope) / 2;
+        segments.push_back(segment);
+        start = i;
+    }
+}
+
+template <class Type>
+size_t LearnedIndex<Type>::predict(const vector<Segment>& segments, size_t s, const Type& item, size_t end){
+    const Segment& segment = segments[s];
+    // Positions of this segment end where the next one starts.
+    size_t segmentEnd = s + 1 < segments.size() ? segments[s + 1].position : end;
+    double estimate = (double)segment.position + segment.slope * keyDistance(item, segment.key);
+    if(!(estimate < (double)segmentEnd))
+        return segmentEnd;
+    return max((size_t)estimate, segment.position);
+}
+
+template <class Type>
+size_t LearnedIndex<Type>::lowerBound(const Type& item) const{
+    if(num == 0 || !(levels[0][0].key < item))
+        return 0;
+
+    // Walk down the levels. At each level s is the last segment whose first key is less than item.
+    size_t s = 0;
+    for(size_t l = levels.size() - 1; l > 0; l--){
+        const vector<Segment>& below = levels[l - 1];
+        size_t predicted = predict(levels[l], s, item, below.size());
+        // Last segment of the level below with key < item, searched within the error window.
+        size_t first = predicted > levelEpsilon + 1 ? predicted - levelEpsilon - 1 : 0;
+        size_t last = min(predicted + levelEpsilon + 2, below.size());
+        // Widen the window if rounding pushed the answer out of it.
+        if(first > 0 && !(below[first].key < item))
+            first = 0;
+        if(last < below.size() && below[last].key < item)
+            last = below.size();
+        while(first + 1 < last){
+            size_t middle = first + (last - first) / 2;
+            if(below[middle].key < item)
+                first = middle;
+            else
+                last = middle;
+        }
+        s = first;
+    }
+
+    // The answer is after the first key of segment s and at most the start of the next segment.
+    const vector<Segment>& bottom = levels[0];
+    size_t segmentStart = bottom[s].position;
+    size_t segmentEnd = s + 1 < bottom.size() ? bottom[s + 1].position : num;
+    size_t predicted = predict(bottom, s, item, num);
+
+    size_t first = predicted > segmentStart + epsilon ? predicted - epsilon : segmentStart;
+    size_t last = min(predicted + epsilon + 1, segmentEnd);
+
+    // Keys that are not in the array may fall after a long run of duplicates, outside the
+    // guaranteed window. Then gallop from the window edge, or search the left part of the segment.
+    if(last < segmentEnd && arr[last] < item)
+        return last + searcher.lowerBound(arr + last, segmentEnd - last, item, searchExponential);
+    if(first > segmentStart && !(arr[first - 1] < item))
+        return segmentStart + searcher.lowerBound(arr + segmentStart, first - segmentStart, item);
+    return first + searcher.lowerBound(arr + first, last - first, item);
+}
+
+template <class Type>
+bool LearnedIndex<Type>::search(const Type& item) const{
+    size_t pos = lowerBound(item);
+    return pos < num && !(item < arr[pos]);
+}
+
+template <class Type>
+size_t LearnedIndex<Type>::sizeInBytes() const{
+    size_t bytes = sizeof(*this);
+    for(size_t l = 0; l < levels.size(); l++)
+        bytes += levels[l].size() * sizeof(Segment);
+    return bytes;
+}
+
+#endif // LEARNEDINDEX_H
@@ -0,0 +1,145 @@
+#ifndef LOOKUPCACHE_H
+#define LOOKUPCACHE_H
+
+#include <SearchHash.h>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+using namespace std;
+
+// Small hash cache of recent search results, for skewed workloads where a few keys make most
+// of the lookups. Attach it to a SearchingAlgo instance with setLookupCache().
+// An entry maps (array, size, key) to whether the key was found, so both positive and negative
+// results are kept. Entries are grouped by 4 in cache line aligned buckets; a key can only be
+// in the bucket its hash selects, so a lookup reads one cache line.
+// When a bucket is full, the entry evicted is chosen by the CLOCK algorithm: entries get a
+// reference bit when they are hit, and the clock hand of the bucket skips (and clears) entries
+// with the bit set. New entries start without the bit, so keys looked up only once are evicted
+// before the hot ones.
+// The cache does not see changes to the contents of an array: call clear() after modifying one.
+// Type needs operator==, and std::hash<Type> to spread its keys over the buckets. Not thread safe, like SearchingAlgo itself.
+template <class Type>
+class LookupCache {
+    public:
+        static const size_t ways = 4;
+
+        // capacity: number of entries, rounded up to a power of 2 number of buckets.
+        explicit LookupCache(size_t capacity = 4096);
+
+        // Return true and set found to the cached result if item was looked up in arr
+        // (num elements) before and is still cached.
+        bool lookup(const Type arr[], size_t num, const Type& item, bool& found);
+
+        // Cache the result of a search of item in arr (num elements).
+        void insert(const Type arr[], size_t num, const Type& item, bool found);
+
+        // Forget every entry, e.g. after an array changed. The counters are kept.
+        void clear();
+
+        size_t capacity() const { return buckets.size() * ways; }
+
+        // Hit-rate counters since the creation of the cache or the last resetCounters().
+        size_t hits() const { return hitCount; }
+        size_t misses() const { return missCount; }
+        size_t evictions() const { return evictionCount; }
+        double hitRate() const { return hitCount + missCount ? (double)hitCount / (hitCount + missCount) : 0; }
+        void resetCounters() { hitCount = missCount = evictionCount = 0; }
+
+    private:
+        struct Entry {
+            Type key;
+            const Type* array;
+            size_t num;
+            bool found;
+        };
+
+        struct alignas(64) Bucket {
+            Entry entries[ways];
+            // One bit per entry: holds a key, and was hit since the clock hand last passed.
+            uint8_t used;
+            uint8_t referenced;
+            uint8_t hand;
+        };
+
+        Bucket& bucketOf(const Type arr[], const Type& item);
+
+        vector<Bucket> buckets;
+        size_t hitCount;
+        size_t missCount;
+        size_t evictionCount;
+};
+
+template <class Type>
+const size_t LookupCache<Type>::ways;
+
+template <class Type>
+LookupCache<Type>::LookupCache(size_t capacity) : hitCount(0), missCount(0), evictionCount(0){
+    size_t numBuckets = 1;
+    while(numBuckets * ways < capacity)
+        numBuckets *= 2;
+    buckets.resize(numBuckets);
+    clear();
+}
+
+template <class Type>
+void LookupCache<Type>::clear(){
+    for(size_t b = 0; b < buckets.size(); b++){
+        buckets[b].used = 0;
+        buckets[b].referenced = 0;
+        buckets[b].hand = 0;
+    }
+}
+
+template <class Type>
+typename LookupCache<Type>::Bucket& LookupCache<Type>::bucketOf(const Type arr[], const Type& item){
+    // Mix the array address into the key hash, then spread the bits (64-bit finalizer of MurmurHash3),
+    // since std::hash of integers is often the identity.
+    uint64_t h = searchHash(item) ^ ((uint64_t)(uintptr_t)arr * 0x9E3779B97F4A7C15ULL);
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    return buckets[h & (buckets.size() - 1)];
+}
+
+template <class Type>
+bool LookupCache<Type>::lookup(const Type arr[], size_t num, const Type& item, bool& found){
+    Bucket& bucket = bucketOf(arr, item);
+    for(size_t w = 0; w < ways; w++){
+        const Entry& entry = bucket.entries[w];
+        if((bucket.used >> w & 1) && entry.array == arr && entry.num == num && entry.key == item){
+            bucket.referenced |= 1 << w;
+            found = entry.found;
+            hitCount++;
+            return true;
+        }
+    }
+    missCount++;
+    return false;
+}
+
+template <class Type>
+void LookupCache<Type>::insert(const Type arr[], size_t num, const Type& item, bool found){
+    Bucket& bucket = bucketOf(arr, item);
+    size_t w = 0;
+    while(w < ways && (bucket.used >> w & 1))
+        w++;
+    if(w == ways){
+        // Bucket full: advance the clock hand past the referenced entries, clearing their bit.
+        while(bucket.referenced >> bucket.hand & 1){
+            bucket.referenced &= ~(1 << bucket.hand);
+            bucket.hand = (bucket.hand + 1) % ways;
+        }
+        w = bucket.hand;
+        bucket.hand = (bucket.hand + 1) % ways;
+        evictionCount++;
+    }
+    Entry& entry = bucket.entries[w];
+    entry.key = item;
+    entry.array = arr;
+    entry.num = num;
+    entry.found = found;
+    bucket.used |= 1 << w;
+    bucket.referenced &= ~(1 << w);
+}
+
+#endif // LOOKUPCACHE_H
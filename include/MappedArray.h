@@ -0,0 +1,312 @@
+#ifndef MAPPEDARRAY_H
+#define MAPPEDARRAY_H
+
+#include <SearchingAlgo.h>
+#include <SimdSearch.h>
+#include <string>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <cerrno>
+#include <algorithm>
+#include <type_traits>
+#ifdef _WIN32
+// Keep windows.h from defining min and max as macros, which break std::min, std::max and
+// numeric_limits in every header included after this one, and from pulling in what is unused.
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+// PrefetchVirtualMemory, used for mappedWillNeed, needs Windows 8.
+#if !defined(_WIN32_WINNT) || _WIN32_WINNT < 0x0602
+#undef _WIN32_WINNT
+#define _WIN32_WINNT 0x0602
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+using namespace std;
+
+// File layout read by MappedArray and written by writeMappedFile():
+// a 64 byte header followed by count elements of elementSize bytes, in the byte order of the
+// machine that wrote them. The header size keeps the elements aligned for any built-in type.
+struct MappedFileHeader {
+    // "SRCHARR1"
+    char magic[8];
+    // mappedTypeCode<Type>() of the elements.
+    uint32_t typeCode;
+    uint32_t elementSize;
+    uint64_t count;
+    // mappedSorted if the elements are sorted ascending.
+    uint32_t flags;
+    uint8_t reserved[36];
+};
+
+const uint32_t mappedSorted = 1;
+
+// Type code stored in the header: 1 and 2 for signed and unsigned 32-bit integers, 3 and 4 for
+// 64-bit integers, 5 for float, 6 for double, 0 for any other type (recognised by its size only).
+template <class Type>
+inline uint32_t mappedTypeCode(){
+    if(is_integral<Type>::value && sizeof(Type) == 4)
+        return is_signed<Type>::value ? 1 : 2;
+    if(is_integral<Type>::value && sizeof(Type) == 8)
+        return is_signed<Type>::value ? 3 : 4;
+    if(is_floating_point<Type>::value && sizeof(Type) == 4)
+        return 5;
+    if(is_floating_point<Type>::value && sizeof(Type) == 8)
+        return 6;
+    return 0;
+}
+
+// Expected pattern of accesses to a mapping, passed to the kernel as a hint: madvise on POSIX;
+// on Windows, FILE_FLAG_RANDOM_ACCESS or FILE_FLAG_SEQUENTIAL_SCAN when the file is opened, and
+// PrefetchVirtualMemory for mappedWillNeed.
+// mappedRandom: searches; no read-ahead, only the probed pages are read.
+// mappedSequential: scans; aggressive read-ahead, pages may be dropped once read.
+// mappedWillNeed: start reading the whole file now, e.g. to warm up a service before use.
+// mappedNormal: the default behaviour of the system.
+enum MappedAccess {
+    mappedNormal,
+    mappedRandom,
+    mappedSequential,
+    mappedWillNeed
+};
+
+// Write arrList (num elements) to path in the MappedArray format.
+// The sorted flag is set if the elements are sorted ascending. Return false on an I/O error.
+template <class Type>
+bool writeMappedFile(const string& path, const Type arrList[], size_t num){
+    MappedFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, "SRCHARR1", sizeof(header.magic));
+    header.typeCode = mappedTypeCode<Type>();
+    header.elementSize = sizeof(Type);
+    header.count = num;
+    header.flags = is_sorted(arrList, arrList + num) ? mappedSorted : 0;
+
+    FILE* file = fopen(path.c_str(), "wb");
+    if(!file)
+        return false;
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1 && (num == 0 || fwrite(arrList, sizeof(Type), num, file) == num);
+    return fclose(file) == 0 && written;
+}
+
+// Read-only view of an array stored in a file, mapped into memory instead of being loaded.
+// Opening costs a few system calls whatever the size of the file; pages are read from disk
+// when first touched, and are shared through the page cache by every process mapping the file.
+// The searches run the SearchingAlgo position methods directly on the mapping.
+// Type must be trivially copyable. Files written on a machine of another byte order are not detected.
+template <class Type>
+class MappedArray {
+    public:
+        MappedArray();
+        ~MappedArray();
+
+        // Map the file at path. access: hint for the expected accesses (see advise()).
+        // hugePages: ask the kernel to back the mapping with huge pages, which makes random
+        // probes of large files cheaper on the TLB. Only a hint: where the system or the file
+        // system does not support it, normal pages are used.
+        // Return false, with the reason in errorMessage(), if the file cannot be mapped or does not
+        // hold elements of Type.
+        bool open(const string& path, MappedAccess access = mappedRandom, bool hugePages = false);
+        void close();
+
+        // Change the access hint of the whole mapping. On Windows only mappedWillNeed has an
+        // effect here: the other hints are flags of the file, given to open().
+        void advise(MappedAccess access);
+
+        bool isOpen() const { return mapping != 0; }
+        const Type* data() const { return elements; }
+        size_t size() const { return num; }
+        // true if the file was written with its elements sorted ascending.
+        bool sorted() const { return isSorted; }
+        const string& errorMessage() const { return error; }
+
+        // Return the index of the first element not less than item, or size() if there is none.
+        // The file must be sorted. method: searchBinary, searchExponential, searchInterpolation...
+        size_t lowerBound(const Type& item, SearchMethod method = searchBinary) const;
+
+        // Return true if item is in the file. Unsorted files are scanned linearly.
+        bool search(const Type& item, SearchMethod method = searchBinary) const;
+
+    private:
+        MappedArray(const MappedArray&);
+        MappedArray& operator=(const MappedArray&);
+
+        // Record the reason of a failed open(), undo the partial mapping and return false.
+        bool fail(const string& reason);
+
+        void* mapping;
+        size_t mappedBytes;
+#ifdef _WIN32
+        HANDLE fileHandle;
+        HANDLE mappingHandle;
+#endif
+        const Type* elements;
+        size_t num;
+        bool isSorted;
+        string error;
+        // SearchingAlgo methods are not const.
+        mutable SearchingAlgo<Type> searcher;
+};
+
+template <class Type>
+MappedArray<Type>::MappedArray()
+    : mapping(0), mappedBytes(0), elements(0), num(0), isSorted(false){
+#ifdef _WIN32
+    fileHandle = INVALID_HANDLE_VALUE;
+    mappingHandle = 0;
+#endif
+}
+
+template <class Type>
+MappedArray<Type>::~MappedArray(){
+    close();
+}
+
+template <class Type>
+bool MappedArray<Type>::fail(const string& reason){
+    close();
+    error = reason;
+    return false;
+}
+
+template <class Type>
+bool MappedArray<Type>::open(const string& path, MappedAccess access, bool hugePages){
+    close();
+    error.clear();
+
+#ifdef _WIN32
+    // Read-ahead hints are flags of the file handle on Windows, set once here. mappedNormal and
+    // mappedWillNeed keep the default read-ahead, as MADV_NORMAL and MADV_WILLNEED do; advise()
+    // then prefetches the file for mappedWillNeed.
+    DWORD accessFlags = 0;
+    if(access == mappedRandom)
+        accessFlags = FILE_FLAG_RANDOM_ACCESS;
+    else if(access == mappedSequential)
+        accessFlags = FILE_FLAG_SEQUENTIAL_SCAN;
+    fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, accessFlags, 0);
+    if(fileHandle == INVALID_HANDLE_VALUE)
+        return fail("cannot open " + path);
+    LARGE_INTEGER fileSize;
+    if(!GetFileSizeEx(fileHandle, &fileSize))
+        return fail("cannot get the size of " + path);
+    mappedBytes = (size_t)fileSize.QuadPart;
+    if(mappedBytes < sizeof(MappedFileHeader))
+        return fail(path + " is too short");
+    // Large pages cannot back file mappings on Windows, so hugePages is ignored.
+    (void)hugePages;
+    mappingHandle = CreateFileMappingA(fileHandle, 0, PAGE_READONLY, 0, 0, 0);
+    if(!mappingHandle)
+        return fail("cannot map " + path);
+    mapping = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    if(!mapping)
+        return fail("cannot map " + path);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+        return fail("cannot open " + path + ": " + strerror(errno));
+    struct stat status;
+    if(fstat(fd, &status) != 0){
+        ::close(fd);
+        return fail("cannot get the size of " + path + ": " + strerror(errno));
+    }
+    mappedBytes = status.st_size;
+    if(mappedBytes < sizeof(MappedFileHeader)){
+        ::close(fd);
+        return fail(path + " is too short");
+    }
+    void* address = mmap(0, mappedBytes, PROT_READ, MAP_SHARED, fd, 0);
+    // The mapping keeps the file alive.
+    ::close(fd);
+    if(address == MAP_FAILED)
+        return fail("cannot map " + path + ": " + strerror(errno));
+    mapping = address;
+#ifdef MADV_HUGEPAGE
+    if(hugePages)
+        madvise(mapping, mappedBytes, MADV_HUGEPAGE);
+#else
+    (void)hugePages;
+#endif
+#endif
+
+    const MappedFileHeader* header = (const MappedFileHeader*)mapping;
+    if(memcmp(header->magic, "SRCHARR1", sizeof(header->magic)) != 0)
+        return fail(path + " is not a sorted key file");
+    if(header->typeCode != mappedTypeCode<Type>() || header->elementSize != sizeof(Type))
+        return fail(path + " holds elements of another type");
+    if(header->count > (mappedBytes - sizeof(MappedFileHeader)) / sizeof(Type))
+        return fail(path + " is shorter than its header says");
+
+    elements = (const Type*)((const char*)mapping + sizeof(MappedFileHeader));
+    num = header->count;
+    isSorted = (header->flags & mappedSorted) != 0;
+    advise(access);
+    return true;
+}
+
+template <class Type>
+void MappedArray<Type>::close(){
+#ifdef _WIN32
+    if(mapping)
+        UnmapViewOfFile(mapping);
+    if(mappingHandle)
+        CloseHandle(mappingHandle);
+    if(fileHandle != INVALID_HANDLE_VALUE)
+        CloseHandle(fileHandle);
+    mappingHandle = 0;
+    fileHandle = INVALID_HANDLE_VALUE;
+#else
+    if(mapping)
+        munmap(mapping, mappedBytes);
+#endif
+    mapping = 0;
+    mappedBytes = 0;
+    elements = 0;
+    num = 0;
+    isSorted = false;
+}
+
+template <class Type>
+void MappedArray<Type>::advise(MappedAccess access){
+    if(!mapping)
+        return;
+#ifdef _WIN32
+    // Windows has no per-range hints besides prefetching; the others are given by open().
+    if(access == mappedWillNeed){
+        WIN32_MEMORY_RANGE_ENTRY range = { mapping, mappedBytes };
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+    }
+#else
+    int advice = MADV_NORMAL;
+    if(access == mappedRandom)
+        advice = MADV_RANDOM;
+    else if(access == mappedSequential)
+        advice = MADV_SEQUENTIAL;
+    else if(access == mappedWillNeed)
+        advice = MADV_WILLNEED;
+    madvise(mapping, mappedBytes, advice);
+#endif
+}
+
+template <class Type>
+size_t MappedArray<Type>::lowerBound(const Type& item, SearchMethod method) const{
+    return searcher.lowerBound(elements, num, item, method);
+}
+
+template <class Type>
+bool MappedArray<Type>::search(const Type& item, SearchMethod method) const{
+    if(!isSorted)
+        return simdFind(elements, num, item) < num;
+    size_t pos = lowerBound(item, method);
+    return pos < num && !(item < elements[pos]);
+}
+
+#endif // MAPPEDARRAY_H
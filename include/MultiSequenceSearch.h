@@ -0,0 +1,327 @@
+#ifndef MULTISEQUENCESEARCH_H
+#define MULTISEQUENCESEARCH_H
+
+#include <SearchHash.h>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+using namespace std;
+
+// Aho-Corasick automaton matching many patterns of elements at once.
+// The patterns are compiled once into an automaton, then a sequence is scanned in a single
+// forward pass that reports every occurrence of every pattern.
+// Elements are mapped to symbols, the distinct elements used by the patterns (Type needs
+// operator< and operator==); any other element is one shared "other" symbol. Symbols are
+// looked up in a hash table when std::hash<Type> exists, by binary search otherwise.
+// States are numbered breadth first. The shallow ones, where a scan spends most of its time,
+// have a dense row of transitions (one entry per symbol), so that a step is one table read:
+// the root always, then whole levels while their rows fit in denseEntries entries.
+// Deeper states keep only their children, sorted by symbol, and follow their failure link
+// for the other symbols, down to a state that has the symbol as a child or a dense row.
+// Memory: 4 * (distinct pattern elements + 1) bytes per dense state, about 24 bytes per state,
+// and the table of the distinct elements; see memoryBytes().
+template <class Type>
+class MultiSequenceMatcher {
+    public:
+        // An occurrence of patterns[pattern] starting at offset in the scanned sequence.
+        struct Match {
+            size_t pattern;
+            size_t offset;
+        };
+
+        // Entries of the dense rows below the root: 256 KB, which stays in the L2 cache.
+        static const size_t denseEntries = 1 << 16;
+
+        // Compile the patterns into the automaton.
+        // Time complexity: O(L log s + s + denseEntries) where L is the total pattern length
+        // and s the number of symbols.
+        explicit MultiSequenceMatcher(const vector<vector<Type> >& patterns);
+
+        size_t patternCount() const { return patternLength.size(); }
+        size_t stateCount() const { return numStates; }
+        // Number of states with a dense row of transitions.
+        size_t denseStateCount() const { return denseStates; }
+        // Bytes used by the tables of the automaton.
+        size_t memoryBytes() const;
+
+        // Return every occurrence of every pattern in [first, last), ordered by end position.
+        // Time complexity: O(n log c + number of matches), c being the largest number of
+        // children of a state; O(n log s + number of matches) without std::hash<Type>.
+        template <class Iterator>
+        vector<Match> findAll(Iterator first, Iterator last) const;
+
+        // Return, for each pattern, whether it occurs in [first, last).
+        template <class Iterator>
+        vector<bool> containsEach(Iterator first, Iterator last) const;
+
+    private:
+        static const uint32_t noState = UINT32_MAX;
+
+        // Return the symbol of element, or otherSymbol if no pattern uses it.
+        uint32_t symbolOf(const Type& element) const;
+
+        // Slot of symbolTable where the probe for element starts.
+        size_t symbolSlot(const Type& element) const;
+
+        // Return the state reached from state by reading symbol.
+        uint32_t step(uint32_t state, uint32_t symbol) const;
+
+        // Call report(pattern, end) for every pattern ending at state, end being the
+        // number of elements read so far.
+        template <class Report>
+        void reportMatches(uint32_t state, size_t end, Report report) const;
+
+        // Sorted distinct elements of the patterns; element alphabet[i] is symbol i.
+        vector<Type> alphabet;
+        uint32_t otherSymbol;
+        // Open addressing table of the symbols, at most half full, noState in empty slots.
+        // Empty if Type has no std::hash: symbolOf() then searches alphabet.
+        vector<uint32_t> symbolTable;
+        size_t symbolMask;
+        // Entries per dense row: one per symbol, plus the other symbol.
+        size_t width;
+        size_t numStates;
+        // States below denseStates have a row: dense[state * width + symbol] is the next state.
+        // State 0 is the root.
+        size_t denseStates;
+        vector<uint32_t> dense;
+        // Children of each state, sorted by symbol: childSymbol and childState from
+        // childStart[state] to childStart[state + 1].
+        vector<uint32_t> childStart;
+        vector<uint32_t> childSymbol;
+        vector<uint32_t> childState;
+        // State of the longest proper suffix of each state, 0 for the root and its children.
+        vector<uint32_t> failure;
+        // First pattern ending exactly at each state, and the next identical pattern.
+        vector<uint32_t> firstPattern;
+        vector<uint32_t> nextPattern;
+        // Nearest state on the failure chain of each state at which a pattern ends.
+        vector<uint32_t> outputLink;
+        vector<size_t> patternLength;
+};
+
+template <class Type>
+const size_t MultiSequenceMatcher<Type>::denseEntries;
+
+template <class Type>
+const uint32_t MultiSequenceMatcher<Type>::noState;
+
+template <class Type>
+MultiSequenceMatcher<Type>::MultiSequenceMatcher(const vector<vector<Type> >& patterns){
+    for(size_t p = 0; p < patterns.size(); p++)
+        alphabet.insert(alphabet.end(), patterns[p].begin(), patterns[p].end());
+    sort(alphabet.begin(), alphabet.end());
+    alphabet.erase(unique(alphabet.begin(), alphabet.end()), alphabet.end());
+    otherSymbol = alphabet.size();
+    width = alphabet.size() + 1;
+
+    symbolMask = 0;
+    if(hasSearchHash<Type>::value){
+        size_t slots = 1;
+        while(slots < 2 * alphabet.size())
+            slots *= 2;
+        symbolMask = slots - 1;
+        symbolTable.assign(slots, noState);
+        for(uint32_t symbol = 0; symbol < alphabet.size(); symbol++){
+            size_t slot = symbolSlot(alphabet[symbol]);
+            while(symbolTable[slot] != noState)
+                slot = (slot + 1) & symbolMask;
+            symbolTable[slot] = symbol;
+        }
+    }
+
+    // Build the trie of the patterns, with the children of each node as (symbol, node) pairs
+    // sorted by symbol.
+    vector<vector<pair<uint32_t, uint32_t> > > trie(1);
+    vector<uint32_t> nodePattern(1, noState);
+    nextPattern.assign(patterns.size(), noState);
+    patternLength.resize(patterns.size());
+    for(size_t p = 0; p < patterns.size(); p++){
+        uint32_t node = 0;
+        for(size_t i = 0; i < patterns[p].size(); i++){
+            uint32_t symbol = symbolOf(patterns[p][i]);
+            vector<pair<uint32_t, uint32_t> >& children = trie[node];
+            typename vector<pair<uint32_t, uint32_t> >::iterator it = lower_bound(children.begin(), children.end(), make_pair(symbol, (uint32_t)0));
+            if(it != children.end() && it->first == symbol){
+                node = it->second;
+                continue;
+            }
+            uint32_t child = trie.size();
+            children.insert(it, make_pair(symbol, child));
+            trie.push_back(vector<pair<uint32_t, uint32_t> >());
+            nodePattern.push_back(noState);
+            node = child;
+        }
+        nextPattern[p] = nodePattern[node];
+        nodePattern[node] = p;
+        patternLength[p] = patterns[p].size();
+    }
+    numStates = trie.size();
+
+    // Number the nodes breadth first, and give dense rows to whole levels from the root.
+    vector<uint32_t> order(1, 0);
+    vector<uint32_t> depth(1, 0);
+    order.reserve(numStates);
+    depth.reserve(numStates);
+    for(size_t head = 0; head < order.size(); head++){
+        const vector<pair<uint32_t, uint32_t> >& children = trie[order[head]];
+        for(size_t c = 0; c < children.size(); c++){
+            order.push_back(children[c].second);
+            depth.push_back(depth[head] + 1);
+        }
+    }
+    denseStates = 1;
+    while(denseStates < numStates){
+        size_t levelEnd = denseStates;
+        while(levelEnd < numStates && depth[levelEnd] == depth[denseStates])
+            levelEnd++;
+        if((levelEnd - 1) * width > denseEntries)
+            break;
+        denseStates = levelEnd;
+    }
+
+    vector<uint32_t> stateOf(numStates);
+    for(size_t s = 0; s < numStates; s++)
+        stateOf[order[s]] = s;
+    childStart.assign(numStates + 1, 0);
+    childSymbol.reserve(numStates - 1);
+    childState.reserve(numStates - 1);
+    firstPattern.resize(numStates);
+    for(size_t s = 0; s < numStates; s++){
+        const vector<pair<uint32_t, uint32_t> >& children = trie[order[s]];
+        for(size_t c = 0; c < children.size(); c++){
+            childSymbol.push_back(children[c].first);
+            childState.push_back(stateOf[children[c].second]);
+        }
+        childStart[s + 1] = childSymbol.size();
+        firstPattern[s] = nodePattern[order[s]];
+    }
+
+    // In breadth first order, the failure state of a state is shallower, so it already has its
+    // failure link, and its dense row if the state has one: a dense row is the row of the
+    // failure state with the children of the state on top.
+    failure.assign(numStates, 0);
+    outputLink.assign(numStates, noState);
+    dense.assign(denseStates * width, 0);
+    for(size_t state = 0; state < numStates; state++){
+        if(state > 0 && state < denseStates)
+            copy(dense.begin() + failure[state] * width, dense.begin() + (failure[state] + 1) * width, dense.begin() + state * width);
+        for(size_t c = childStart[state]; c < childStart[state + 1]; c++){
+            uint32_t child = childState[c];
+            uint32_t fallback = state == 0 ? 0 : step(failure[state], childSymbol[c]);
+            failure[child] = fallback;
+            outputLink[child] = firstPattern[fallback] != noState ? fallback : outputLink[fallback];
+            if(state < denseStates)
+                dense[state * width + childSymbol[c]] = child;
+        }
+    }
+}
+
+template <class Type>
+size_t MultiSequenceMatcher<Type>::memoryBytes() const{
+    return alphabet.capacity() * sizeof(Type) + patternLength.capacity() * sizeof(size_t)
+        + (symbolTable.capacity() + dense.capacity() + childStart.capacity() + childSymbol.capacity()
+           + childState.capacity() + failure.capacity() + firstPattern.capacity() + nextPattern.capacity()
+           + outputLink.capacity()) * sizeof(uint32_t);
+}
+
+template <class Type>
+size_t MultiSequenceMatcher<Type>::symbolSlot(const Type& element) const{
+    // 64-bit finalizer of MurmurHash3, since std::hash of integers is often the identity.
+    uint64_t h = searchHash(element);
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33;
+    return h & symbolMask;
+}
+
+template <class Type>
+uint32_t MultiSequenceMatcher<Type>::symbolOf(const Type& element) const{
+    if(!symbolTable.empty()){
+        for(size_t slot = symbolSlot(element); symbolTable[slot] != noState; slot = (slot + 1) & symbolMask){
+            if(alphabet[symbolTable[slot]] == element)
+                return symbolTable[slot];
+        }
+        return otherSymbol;
+    }
+    typename vector<Type>::const_iterator it = lower_bound(alphabet.begin(), alphabet.end(), element);
+    if(it != alphabet.end() && *it == element)
+        return it - alphabet.begin();
+    return otherSymbol;
+}
+
+template <class Type>
+uint32_t MultiSequenceMatcher<Type>::step(uint32_t state, uint32_t symbol) const{
+    // The root has a dense row, so the failure chain always ends on one.
+    while(state >= denseStates){
+        const uint32_t* first = childSymbol.data() + childStart[state];
+        const uint32_t* last = childSymbol.data() + childStart[state + 1];
+        const uint32_t* child = lower_bound(first, last, symbol);
+        if(child != last && *child == symbol)
+            return childState[child - childSymbol.data()];
+        state = failure[state];
+    }
+    return dense[(size_t)state * width + symbol];
+}
+
+template <class Type>
+template <class Report>
+void MultiSequenceMatcher<Type>::reportMatches(uint32_t state, size_t end, Report report) const{
+    if(firstPattern[state] == noState)
+        state = outputLink[state];
+    while(state != noState){
+        for(uint32_t p = firstPattern[state]; p != noState; p = nextPattern[p])
+            report(p, end);
+        state = outputLink[state];
+    }
+}
+
+template <class Type>
+template <class Iterator>
+vector<typename MultiSequenceMatcher<Type>::Match> MultiSequenceMatcher<Type>::findAll(Iterator first, Iterator last) const{
+    vector<Match> matches;
+    const vector<size_t>& lengths = patternLength;
+    auto report = [&matches, &lengths](uint32_t pattern, size_t end){
+        Match match = { pattern, end - lengths[pattern] };
+        matches.push_back(match);
+    };
+
+    uint32_t state = 0;
+    size_t end = 0;
+    // Empty patterns match before the first element.
+    reportMatches(state, end, report);
+    for(; first != last; ++first){
+        state = step(state, symbolOf(*first));
+        end++;
+        if(firstPattern[state] != noState || outputLink[state] != noState)
+            reportMatches(state, end, report);
+    }
+    return matches;
+}
+
+template <class Type>
+template <class Iterator>
+vector<bool> MultiSequenceMatcher<Type>::containsEach(Iterator first, Iterator last) const{
+    vector<bool> found(patternCount(), false);
+    // Once every pattern ending at a state has been reported, the state need not be reported again.
+    vector<bool> stateReported(numStates, false);
+    auto report = [&found](uint32_t pattern, size_t){ found[pattern] = true; };
+
+    uint32_t state = 0;
+    reportMatches(state, 0, report);
+    stateReported[0] = true;
+    for(; first != last; ++first){
+        state = step(state, symbolOf(*first));
+        if(!stateReported[state]){
+            reportMatches(state, 0, report);
+            stateReported[state] = true;
+        }
+    }
+    return found;
+}
+
+#endif // MULTISEQUENCESEARCH_H
@@ -0,0 +1,169 @@
+#ifndef PARALLELSEARCH_H
+#define PARALLELSEARCH_H
+
+#include <SearchingAlgo.h>
+#include <ThreadPool.h>
+#include <atomic>
+#include <vector>
+using namespace std;
+
+// Linear searches over large unsorted arrays, split into chunks that are scanned
+// by the threads of a persistent ThreadPool.
+// The chunk size grows with the array so that each thread gets about chunksPerThread chunks,
+// enough to even out the load, but no chunk is smaller than minChunkSize: waking a worker costs
+// about as much as scanning 256 KB. Arrays smaller than sequentialLimit, which would not make
+// two such chunks, are scanned on the calling thread only.
+template <class Type>
+class ParallelSearch {
+    public:
+        // Smallest number of elements handed to a thread: 256 KB of elements.
+        static const size_t minChunkSize = (1 << 18) / sizeof(Type) > 0 ? (1 << 18) / sizeof(Type) : 1;
+        // Chunks per thread of the pool, for arrays large enough.
+        static const size_t chunksPerThread = 4;
+        // Arrays with fewer elements than this are not worth waking up the pool for.
+        static const size_t sequentialLimit = 2 * minChunkSize;
+
+        // numThreads: number of threads used by each search, including the caller.
+        // 0 uses the number of hardware threads.
+        explicit ParallelSearch(unsigned numThreads = 0) : pool(numThreads) {}
+
+        unsigned threadCount() const { return pool.size(); }
+
+        // Number of elements of each chunk handed to a thread for an array of num elements.
+        size_t chunkSizeFor(size_t num) const;
+
+        // Return true if item is in arrList.
+        // All threads stop scanning as soon as one of them finds item.
+        // Time complexity: O(n / p) where p is the number of threads.
+        bool linearSearch(const Type arrList[], size_t num, const Type& item);
+
+        // Return the index of the first element equal to item, or num if there is none.
+        // Chunks after a match already found are skipped.
+        size_t findFirst(const Type arrList[], size_t num, const Type& item);
+
+        // Return the number of elements equal to item.
+        size_t countMatches(const Type arrList[], size_t num, const Type& item);
+
+        // Return the positions of all elements equal to item, in ascending order.
+        vector<size_t> findAll(const Type arrList[], size_t num, const Type& item);
+
+    private:
+        static size_t numChunks(size_t num, size_t chunkSize) { return (num + chunkSize - 1) / chunkSize; }
+
+        ThreadPool pool;
+};
+
+template <class Type>
+const size_t ParallelSearch<Type>::minChunkSize;
+
+template <class Type>
+const size_t ParallelSearch<Type>::chunksPerThread;
+
+template <class Type>
+const size_t ParallelSearch<Type>::sequentialLimit;
+
+template <class Type>
+size_t ParallelSearch<Type>::chunkSizeFor(size_t num) const{
+    size_t chunks = chunksPerThread * pool.size();
+    return max(minChunkSize, (num + chunks - 1) / chunks);
+}
+
+template <class Type>
+bool ParallelSearch<Type>::linearSearch(const Type arrList[], size_t num, const Type& item){
+    if(num < sequentialLimit || pool.size() == 1)
+        return simdFind(arrList, num, item) < num;
+
+    atomic<bool> found(false);
+    size_t chunkSize = chunkSizeFor(num);
+    pool.run(numChunks(num, chunkSize), [&](size_t chunk){
+        // A chunk is scanned in slices, checking between slices whether another thread is done.
+        const size_t sliceSize = 1 << 12;
+        size_t first = chunk * chunkSize;
+        size_t last = min(first + chunkSize, num);
+        for(size_t i = first; i < last && !found.load(memory_order_relaxed); i += sliceSize){
+            size_t count = min(sliceSize, last - i);
+            if(simdFind(arrList + i, count, item) < count)
+                found.store(true, memory_order_relaxed);
+        }
+    });
+    return found;
+}
+
+template <class Type>
+size_t ParallelSearch<Type>::findFirst(const Type arrList[], size_t num, const Type& item){
+    if(num < sequentialLimit || pool.size() == 1)
+        return simdFind(arrList, num, item);
+
+    // Smallest matching index found so far.
+    atomic<size_t> best(num);
+    size_t chunkSize = chunkSizeFor(num);
+    pool.run(numChunks(num, chunkSize), [&](size_t chunk){
+        const size_t sliceSize = 1 << 12;
+        size_t first = chunk * chunkSize;
+        size_t last = min(first + chunkSize, num);
+        // Slices are taken in ascending order, so the first match of the chunk ends its scan.
+        for(size_t i = first; i < last && i < best.load(memory_order_relaxed); i += sliceSize){
+            size_t count = min(sliceSize, last - i);
+            size_t pos = simdFind(arrList + i, count, item);
+            if(pos < count){
+                size_t current = best.load();
+                while(i + pos < current && !best.compare_exchange_weak(current, i + pos))
+                    ;
+                return;
+            }
+        }
+    });
+    return best;
+}
+
+template <class Type>
+size_t ParallelSearch<Type>::countMatches(const Type arrList[], size_t num, const Type& item){
+    atomic<size_t> total(0);
+    size_t chunkSize = chunkSizeFor(num);
+    // No early exit: the counting loop has no branch and can be vectorized.
+    auto countChunk = [&](size_t chunk){
+        size_t first = chunk * chunkSize;
+        size_t last = min(first + chunkSize, num);
+        size_t count = 0;
+        for(size_t i = first; i < last; i++)
+            count += (arrList[i] == item);
+        total += count;
+    };
+
+    if(num < sequentialLimit || pool.size() == 1){
+        for(size_t chunk = 0; chunk < numChunks(num, chunkSize); chunk++)
+            countChunk(chunk);
+    }
+    else
+        pool.run(numChunks(num, chunkSize), countChunk);
+    return total;
+}
+
+template <class Type>
+vector<size_t> ParallelSearch<Type>::findAll(const Type arrList[], size_t num, const Type& item){
+    // Each chunk collects its own positions, then they are joined in chunk order.
+    size_t chunkSize = chunkSizeFor(num);
+    vector<vector<size_t> > chunkPositions(numChunks(num, chunkSize));
+    auto scanChunk = [&](size_t chunk){
+        size_t first = chunk * chunkSize;
+        size_t last = min(first + chunkSize, num);
+        for(size_t i = first; i < last; i++){
+            if(arrList[i] == item)
+                chunkPositions[chunk].push_back(i);
+        }
+    };
+
+    if(num < sequentialLimit || pool.size() == 1){
+        for(size_t chunk = 0; chunk < chunkPositions.size(); chunk++)
+            scanChunk(chunk);
+    }
+    else
+        pool.run(chunkPositions.size(), scanChunk);
+
+    vector<size_t> positions;
+    for(size_t chunk = 0; chunk < chunkPositions.size(); chunk++)
+        positions.insert(positions.end(), chunkPositions[chunk].begin(), chunkPositions[chunk].end());
+    return positions;
+}
+
+#endif // PARALLELSEARCH_H
@@ -0,0 +1,95 @@
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <cstring>
+#include <cstdint>
+#endif
+
+// Hardware counters of the calling thread for cache misses and branch mispredictions,
+// read through perf_event_open on Linux. On other systems, or when the kernel refuses
+// access (see /proc/sys/kernel/perf_event_paranoid), available() is false and the
+// counts stay 0.
+class PerfCounters {
+    public:
+        PerfCounters();
+        ~PerfCounters();
+
+        bool available() const { return cacheFd >= 0 && branchFd >= 0; }
+
+        // Reset the counters and start counting.
+        void start();
+        // Stop counting and read the counters.
+        void stop();
+
+        unsigned long long cacheMisses() const { return cacheCount; }
+        unsigned long long branchMisses() const { return branchCount; }
+
+    private:
+        PerfCounters(const PerfCounters&);
+        PerfCounters& operator=(const PerfCounters&);
+
+        int cacheFd;
+        int branchFd;
+        unsigned long long cacheCount;
+        unsigned long long branchCount;
+};
+
+#ifdef __linux__
+
+// Open one hardware counter of the calling thread, in the group of groupFd (-1 to lead a new group).
+inline int openPerfCounter(uint64_t config, int groupFd){
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.disabled = groupFd < 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, 0);
+}
+
+inline PerfCounters::PerfCounters() : cacheCount(0), branchCount(0){
+    cacheFd = openPerfCounter(PERF_COUNT_HW_CACHE_MISSES, -1);
+    branchFd = cacheFd >= 0 ? openPerfCounter(PERF_COUNT_HW_BRANCH_MISSES, cacheFd) : -1;
+}
+
+inline PerfCounters::~PerfCounters(){
+    if(branchFd >= 0)
+        close(branchFd);
+    if(cacheFd >= 0)
+        close(cacheFd);
+}
+
+inline void PerfCounters::start(){
+    if(!available())
+        return;
+    ioctl(cacheFd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(cacheFd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+inline void PerfCounters::stop(){
+    if(!available())
+        return;
+    ioctl(cacheFd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    if(read(cacheFd, &cacheCount, sizeof(cacheCount)) != sizeof(cacheCount))
+        cacheCount = 0;
+    if(read(branchFd, &branchCount, sizeof(branchCount)) != sizeof(branchCount))
+        branchCount = 0;
+}
+
+#else
+
+inline PerfCounters::PerfCounters() : cacheFd(-1), branchFd(-1), cacheCount(0), branchCount(0) {}
+inline PerfCounters::~PerfCounters() {}
+inline void PerfCounters::start() {}
+inline void PerfCounters::stop() {}
+
+#endif // __linux__
+
+#endif // PERFCOUNTERS_H
@@ -0,0 +1,325 @@
+#ifndef RANGESEARCH_H
+#define RANGESEARCH_H
+
+#if __cplusplus < 202002L
+#error "RangeSearch.h needs C++20 (-std=c++20)"
+#endif
+
+#include <SearchingAlgo.h>
+#include <SimdSearch.h>
+#include <ranges>
+#include <iterator>
+#include <functional>
+#include <concepts>
+#include <memory>
+#include <type_traits>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+using namespace std;
+
+// The SearchingAlgo methods as free functions on iterators and ranges, in the style of the
+// std::ranges algorithms: they search std::vector, std::deque, std::array, spans and plain
+// arrays alike, compare with any strict weak order comp, and compare proj(element) instead of
+// the element, e.g. a field of a struct (&Record::key). So arrays of records are searched in
+// place, without copying their keys out.
+// Nothing is allocated and no element is copied; there is no object to create.
+// The sorted searches take the SearchMethod of SearchingAlgo::lowerBound last; the range must be
+// sorted by comp on the projected keys. searchInterpolation only interpolates for arithmetic keys
+// compared with ranges::less or less<>, and bisects otherwise.
+// Needs C++20.
+
+// Partition points: the first element of [first, first + count) for which inPrefix is false.
+// inPrefix must be true for a prefix of the range and false for the rest.
+
+template <random_access_iterator Iterator, class Predicate>
+Iterator binaryPartitionPoint(Iterator first, iter_difference_t<Iterator> count, Predicate& inPrefix){
+    while(count > 0){
+        iter_difference_t<Iterator> half = count / 2;
+        Iterator middle = first + half;
+        if(inPrefix(*middle)){
+            first = middle + 1;
+            count -= half + 1;
+        }
+        else
+            count = half;
+    }
+    return first;
+}
+
+template <random_access_iterator Iterator, class Predicate>
+Iterator exponentialPartitionPoint(Iterator first, iter_difference_t<Iterator> count, Predicate& inPrefix){
+    if(count == 0 || !inPrefix(first[0]))
+        return first;
+    // Double the index until it reaches an element outside the prefix or the end of the range.
+    iter_difference_t<Iterator> index = 1;
+    while(index < count && inPrefix(first[index]))
+        index *= 2;
+    return binaryPartitionPoint(first + (index / 2 + 1), min(index, count) - (index / 2 + 1), inPrefix);
+}
+
+template <random_access_iterator Iterator, class Predicate>
+Iterator fibonacciPartitionPoint(Iterator first, iter_difference_t<Iterator> count, Predicate& inPrefix){
+    typedef iter_difference_t<Iterator> Difference;
+    Difference fibN_1 = 1, fibN_2 = 0, fib = 1;
+    // Determine the smallest fibonacci number greater or equal to count.
+    while(fib < count){
+        fibN_2 = fibN_1;
+        fibN_1 = fib;
+        fib = fibN_1 + fibN_2;
+    }
+    // Number of leading elements known to be in the prefix.
+    Difference offset = 0;
+    while(fib > 1){
+        Difference index = min(offset + fibN_2, count) - 1;
+        if(inPrefix(first[index])){
+            fib = fibN_1;
+            fibN_1 = fibN_2;
+            fibN_2 = fib - fibN_1;
+            offset = index + 1;
+        }
+        else{
+            fib = fibN_2;
+            fibN_1 = fibN_1 - fibN_2;
+            fibN_2 = fib - fibN_1;
+        }
+    }
+    if(fib && offset < count && inPrefix(first[offset]))
+        offset++;
+    return first + offset;
+}
+
+template <random_access_iterator Iterator, class Predicate>
+Iterator jumpPartitionPoint(Iterator first, iter_difference_t<Iterator> count, Predicate& inPrefix){
+    typedef iter_difference_t<Iterator> Difference;
+    if(count == 0)
+        return first;
+    Difference step = max((Difference)sqrt((double)count), (Difference)1);
+    Difference prev = 0, jumpLoc = min(step, count);
+    // Jump ahead while the last element of the block is in the prefix.
+    while(inPrefix(first[jumpLoc - 1])){
+        if(jumpLoc == count)
+            return first + count;
+        prev = jumpLoc;
+        jumpLoc = min(jumpLoc + step, count);
+    }
+    while(inPrefix(first[prev]))
+        prev++;
+    return first + prev;
+}
+
+// Position between first and last (inclusive) where key would be, estimated from the keys there,
+// as SearchingAlgo::interpolationProbe does: exact for integers, through double otherwise.
+// The keys and the value are first converted to their common type, as the comparisons of
+// ranges::less convert them, so that an int value searched among unsigned keys is placed where
+// the comparisons put it.
+template <class Key, class Value>
+size_t interpolationPosition(const Key& lowKey, const Key& highKey, const Value& value, size_t first, size_t last){
+    typedef common_type_t<Key, Value> Common;
+    Common low = lowKey, high = highKey, key = value;
+    if(!(key > low))
+        return first;
+    if(!(key < high))
+        return last;
+    size_t pos;
+    if constexpr(is_integral_v<Common>){
+        unsigned long long span = (unsigned long long)high - (unsigned long long)low;
+        unsigned long long offset = (unsigned long long)key - (unsigned long long)low;
+#ifdef __SIZEOF_INT128__
+        pos = first + (size_t)((unsigned __int128)offset * (last - first) / span);
+#else
+        pos = first + (size_t)((long double)offset / span * (last - first));
+#endif
+    }
+    else{
+        double ratio = ((double)key - (double)low) / ((double)high - (double)low);
+        if(!(ratio > 0))
+            return first;
+        if(!(ratio < 1))
+            return last;
+        pos = first + (size_t)(ratio * (last - first));
+    }
+    // Unsorted keys or rounding must not send the probe out of the range.
+    return min(max(pos, first), last);
+}
+
+// True when searchInterpolation can interpolate keys of type Key for values of type Value.
+template <class Key, class Value, class Compare>
+constexpr bool canInterpolate = is_arithmetic_v<Key> && is_arithmetic_v<Value> &&
+                                (is_same_v<Compare, ranges::less> || is_same_v<Compare, less<> >);
+
+// Interpolation search for the partition point, with the safeguards of
+// SearchingAlgo::interpolationSearch: a bisection step after any probe that fails to halve the
+// range, and only bisection after a few probes. key(element) is the key interpolated on.
+template <random_access_iterator Iterator, class Value, class Key, class Predicate>
+Iterator interpolationPartitionPoint(Iterator first, iter_difference_t<Iterator> count, const Value& value, Key& key, Predicate& inPrefix){
+    size_t low = 0, high = count;
+    int logN = 0, logLogN = 0;
+    for(size_t n = count; n >>= 1; )
+        logN++;
+    while(logN >>= 1)
+        logLogN++;
+    int probesLeft = 2 * logLogN + 4;
+    bool bisect = false;
+    while(low < high){
+        size_t oldSize = high - low;
+        size_t pos;
+        if(bisect || probesLeft <= 0)
+            pos = low + oldSize / 2;
+        else{
+            pos = interpolationPosition(key(first[low]), key(first[high - 1]), value, low, high - 1);
+            probesLeft--;
+        }
+        if(inPrefix(first[pos]))
+            low = pos + 1;
+        else
+            high = pos;
+        bisect = !bisect && high - low > oldSize / 2;
+    }
+    return first + low;
+}
+
+// Partition point found with method. key and value are used by searchInterpolation only.
+template <random_access_iterator Iterator, class Value, class Compare, class Projection, class Predicate>
+Iterator partitionPointBy(Iterator first, iter_difference_t<Iterator> count, const Value& value, Projection& proj, Predicate& inPrefix, SearchMethod method){
+    switch(method){
+        case searchExponential:
+            return exponentialPartitionPoint(first, count, inPrefix);
+        case searchFibonacci:
+            return fibonacciPartitionPoint(first, count, inPrefix);
+        case searchJump:
+            return jumpPartitionPoint(first, count, inPrefix);
+        case searchInterpolation:
+            if constexpr(canInterpolate<remove_cvref_t<indirect_result_t<Projection&, Iterator> >, Value, Compare>){
+                auto key = [&proj](const iter_value_t<Iterator>& element) -> decltype(auto) { return invoke(proj, element); };
+                return interpolationPartitionPoint(first, count, value, key, inPrefix);
+            }
+            else
+                return binaryPartitionPoint(first, count, inPrefix);
+        default:
+            return binaryPartitionPoint(first, count, inPrefix);
+    }
+}
+
+// Constraints of the sorted searches: a random access range whose projected elements can be
+// ordered against value by comp.
+template <class Iterator, class Value, class Compare, class Projection>
+concept SortedSearchable = random_access_iterator<Iterator> &&
+                           indirect_strict_weak_order<Compare, const Value*, projected<Iterator, Projection> >;
+
+// Return the first element whose key is not before value, or last if there is none.
+// Time complexity: that of method, e.g. O(log n) for searchBinary.
+template <random_access_iterator Iterator, sized_sentinel_for<Iterator> Sentinel, class Value,
+          class Compare = ranges::less, class Projection = identity>
+    requires SortedSearchable<Iterator, Value, Compare, Projection>
+Iterator rangeLowerBound(Iterator first, Sentinel last, const Value& value, Compare comp = {}, Projection proj = {}, SearchMethod method = searchBinary){
+    auto inPrefix = [&](const auto& element){ return invoke(comp, invoke(proj, element), value); };
+    return partitionPointBy<Iterator, Value, Compare>(first, last - first, value, proj, inPrefix, method);
+}
+
+// Return the first element whose key is after value, or last if there is none.
+template <random_access_iterator Iterator, sized_sentinel_for<Iterator> Sentinel, class Value,
+          class Compare = ranges::less, class Projection = identity>
+    requires SortedSearchable<Iterator, Value, Compare, Projection>
+Iterator rangeUpperBound(Iterator first, Sentinel last, const Value& value, Compare comp = {}, Projection proj = {}, SearchMethod method = searchBinary){
+    auto inPrefix = [&](const auto& element){ return !invoke(comp, value, invoke(proj, element)); };
+    return partitionPointBy<Iterator, Value, Compare>(first, last - first, value, proj, inPrefix, method);
+}
+
+template <ranges::random_access_range Range, class Value, class Compare = ranges::less, class Projection = identity>
+    requires ranges::sized_range<Range> && SortedSearchable<ranges::iterator_t<Range>, Value, Compare, Projection>
+ranges::borrowed_iterator_t<Range> rangeLowerBound(Range&& range, const Value& value, Compare comp = {}, Projection proj = {}, SearchMethod method = searchBinary){
+    return rangeLowerBound(ranges::begin(range), ranges::begin(range) + ranges::distance(range), value, comp, proj, method);
+}
+
+template <ranges::random_access_range Range, class Value, class Compare = ranges::less, class Projection = identity>
+    requires ranges::sized_range<Range> && SortedSearchable<ranges::iterator_t<Range>, Value, Compare, Projection>
+ranges::borrowed_iterator_t<Range> rangeUpperBound(Range&& range, const Value& value, Compare comp = {}, Projection proj = {}, SearchMethod method = searchBinary){
+    return rangeUpperBound(ranges::begin(range), ranges::begin(range) + ranges::distance(range), value, comp, proj, method);
+}
+
+// Return the elements whose key is equivalent to value; empty, at the insertion point, if there is none.
+template <ranges::random_access_range Range, class Value, class Compare = ranges::less, class Projection = identity>
+    requires ranges::sized_range<Range> && SortedSearchable<ranges::iterator_t<Range>, Value, Compare, Projection>
+ranges::borrowed_subrange_t<Range> rangeEqualRange(Range&& range, const Value& value, Compare comp = {}, Projection proj = {}, SearchMethod method = searchBinary){
+    auto first = rangeLowerBound(range, value, comp, proj, method);
+    auto end = ranges::begin(range) + ranges::distance(range);
+    // The equal elements follow the lower bound, usually few of them: gallop over them.
+    auto inPrefix = [&](const auto& element){ return !invoke(comp, value, invoke(proj, element)); };
+    return {first, exponentialPartitionPoint(first, end - first, inPrefix)};
+}
+
+// Return the first element whose key is equivalent to value, or the end of range if there is none.
+template <ranges::random_access_range Range, class Value, class Compare = ranges::less, class Projection = identity>
+    requires ranges::sized_range<Range> && SortedSearchable<ranges::iterator_t<Range>, Value, Compare, Projection>
+ranges::borrowed_iterator_t<Range> rangeFindPosition(Range&& range, const Value& value, Compare comp = {}, Projection proj = {}, SearchMethod method = searchBinary){
+    auto pos = rangeLowerBound(range, value, comp, proj, method);
+    auto end = ranges::begin(range) + ranges::distance(range);
+    return pos != end && !invoke(comp, value, invoke(proj, *pos)) ? pos : end;
+}
+
+// Return true if an element of range has a key equivalent to value: binarySearch, jumpSearch,
+// interpolationSearch, exponentialSearch or fibonacciSearch, as selected by method.
+template <ranges::random_access_range Range, class Value, class Compare = ranges::less, class Projection = identity>
+    requires ranges::sized_range<Range> && SortedSearchable<ranges::iterator_t<Range>, Value, Compare, Projection>
+bool rangeSearch(Range&& range, const Value& value, Compare comp = {}, Projection proj = {}, SearchMethod method = searchBinary){
+    return rangeFindPosition(range, value, comp, proj, method) != ranges::begin(range) + ranges::distance(range);
+}
+
+// Return the elements whose keys k satisfy !comp(k, lo) && !comp(hi, k), that is lo <= k <= hi
+// for ranges::less; see SearchingAlgo::rangeQuery.
+template <ranges::random_access_range Range, class Value, class Compare = ranges::less, class Projection = identity>
+    requires ranges::sized_range<Range> && SortedSearchable<ranges::iterator_t<Range>, Value, Compare, Projection>
+ranges::borrowed_subrange_t<Range> rangeQuery(Range&& range, const Value& lo, const Value& hi, Compare comp = {}, Projection proj = {}){
+    auto first = ranges::begin(range);
+    auto last = first + ranges::distance(range);
+    // Both bounds lie within [first, last].
+    while(first < last){
+        auto middle = first + (last - first) / 2;
+        if(invoke(comp, invoke(proj, *middle), lo))
+            first = middle + 1;
+        else if(invoke(comp, hi, invoke(proj, *middle)))
+            last = middle;
+        else{
+            auto beforeLo = [&](const auto& element){ return invoke(comp, invoke(proj, element), lo); };
+            auto notAfterHi = [&](const auto& element){ return !invoke(comp, hi, invoke(proj, element)); };
+            return {binaryPartitionPoint(first, middle - first, beforeLo), exponentialPartitionPoint(middle + 1, last - middle - 1, notAfterHi)};
+        }
+    }
+    return {first, first};
+}
+
+// Linear search: return the first element whose key equals value, or the end of range.
+// Works on any input range, sorted or not. Contiguous ranges of 32/64-bit integers, float or
+// double searched without projection use the SIMD kernels of simdFind().
+// Time complexity: O(n)
+template <ranges::input_range Range, class Value, class Projection = identity>
+    requires indirect_binary_predicate<ranges::equal_to, projected<ranges::iterator_t<Range>, Projection>, const Value*>
+ranges::borrowed_iterator_t<Range> rangeLinearSearch(Range&& range, const Value& value, Projection proj = {}){
+    typedef ranges::range_value_t<Range> Element;
+    if constexpr(ranges::contiguous_range<Range> && ranges::sized_range<Range> && is_same_v<Projection, identity> && is_same_v<Element, Value> && is_arithmetic_v<Element>){
+        auto first = ranges::begin(range);
+        size_t num = ranges::size(range);
+        return first + simdFind(to_address(first), num, value);
+    }
+    else{
+        auto first = ranges::begin(range);
+        auto last = ranges::end(range);
+        while(first != last && !(invoke(proj, *first) == value))
+            ++first;
+        return first;
+    }
+}
+
+// Sublist search: return the first occurrence in range of the elements of pattern, compared
+// through their projections with pred, or an empty subrange at the end of range.
+// Unlike SearchingAlgo::sublistSearch, no failure table is built, so nothing is allocated, and
+// the worst case is O(m*n); it is close to O(n) unless the pattern often almost matches.
+template <ranges::forward_range Range, ranges::forward_range Pattern, class Predicate = ranges::equal_to,
+          class Projection1 = identity, class Projection2 = identity>
+    requires indirectly_comparable<ranges::iterator_t<Range>, ranges::iterator_t<Pattern>, Predicate, Projection1, Projection2>
+ranges::borrowed_subrange_t<Range> rangeSublistSearch(Range&& range, Pattern&& pattern, Predicate pred = {}, Projection1 proj1 = {}, Projection2 proj2 = {}){
+    return ranges::search(range, pattern, pred, proj1, proj2);
+}
+
+#endif // RANGESEARCH_H
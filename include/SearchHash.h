@@ -0,0 +1,29 @@
+#ifndef SEARCHHASH_H
+#define SEARCHHASH_H
+
+#include <functional>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+using namespace std;
+
+// Hash of item used by the hashed structures (LookupCache, BloomFilter, the symbol table of
+// MultiSequenceMatcher): std::hash<Type> where it exists. Other types all hash to 0, which keeps
+// them usable, but puts every key in the same place.
+template <class Type>
+inline size_t searchHash(const Type& item, typename enable_if<is_same<decltype(hash<Type>()(item)), size_t>::value, int>::type = 0){
+    return hash<Type>()(item);
+}
+
+inline size_t searchHash(...){
+    return 0;
+}
+
+// True if searchHash() of a Type uses std::hash<Type>, false if it is always 0.
+template <class Type, class = size_t>
+struct hasSearchHash : false_type {};
+
+template <class Type>
+struct hasSearchHash<Type, decltype(hash<Type>()(declval<const Type&>()))> : true_type {};
+
+#endif // SEARCHHASH_H
@@ -0,0 +1,302 @@
+#ifndef SEARCHSTATS_H
+#define SEARCHSTATS_H
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+using namespace std;
+
+// Statistics of the searches of SearchingAlgo, collected only when the code is compiled with
+// SEARCHINGALGO_INSTRUMENT defined (e.g. -DSEARCHINGALGO_INSTRUMENT). Without it the counting
+// macros expand to nothing and the searches run exactly as before.
+// Each instrumented search counts, per call:
+// - probes: elements of the array read,
+// - comparisons: comparisons of an element with the item,
+// - iterations: steps of the method's main loop (halvings for binary search, jumps for jump
+//   search, Fibonacci steps for fibonacciSearch, doublings and halvings for exponential search,
+//   elements visited for linear searches),
+// and its latency is recorded in a histogram.
+// A batch method (binarySearchBatch, rangeQueryBatch, nearestSearchBatch) makes one call per
+// batch, its counts summed over the keys. The sublist and sequence searches count the elements
+// of the searched sequence read by their matcher as probes and iterations; the comparisons made
+// inside the matchers are not counted.
+// A search run by another one, e.g. lowerBound by findPosition, is a call of its own method as
+// well, and its counts and time are included in those of the caller.
+
+// Methods with statistics.
+enum StatsMethod {
+    statsLinear,
+    statsBinary,
+    statsJump,
+    statsInterpolation,
+    statsExponential,
+    statsFibonacci,
+    statsRecursiveLinear,
+    statsLowerBound,
+    statsUpperBound,
+    statsEqualRange,
+    statsFindPosition,
+    statsBinaryBatch,
+    statsRangeQuery,
+    statsRangeQueryBatch,
+    statsNearest,
+    statsKNearest,
+    statsApproximate,
+    statsNearestBatch,
+    statsSublist,
+    statsMultiSublist,
+    statsSequence,
+    statsMethodCount
+};
+
+// Return the name of method, e.g. "binarySearch" for statsBinary.
+inline const char* statsMethodName(StatsMethod method){
+    switch(method){
+        case statsLinear: return "linearSearch";
+        case statsBinary: return "binarySearch";
+        case statsJump: return "jumpSearch";
+        case statsInterpolation: return "interpolationSearch";
+        case statsExponential: return "exponentialSearch";
+        case statsFibonacci: return "fibonacciSearch";
+        case statsRecursiveLinear: return "recursiveLinearSearch";
+        case statsLowerBound: return "lowerBound";
+        case statsUpperBound: return "upperBound";
+        case statsEqualRange: return "equalRange";
+        case statsFindPosition: return "findPosition";
+        case statsBinaryBatch: return "binarySearchBatch";
+        case statsRangeQuery: return "rangeQuery";
+        case statsRangeQueryBatch: return "rangeQueryBatch";
+        case statsNearest: return "nearestSearch";
+        case statsKNearest: return "kNearestSearch";
+        case statsApproximate: return "approximateSearch";
+        case statsNearestBatch: return "nearestSearchBatch";
+        case statsSublist: return "sublistSearch";
+        case statsMultiSublist: return "multiSublistSearch";
+        case statsSequence: return "sequenceSearch";
+        case statsMethodCount: break;
+    }
+    return "unknown";
+}
+
+// Work done by one search, or summed over many.
+struct SearchCallCounts {
+    uint64_t probes;
+    uint64_t comparisons;
+    uint64_t iterations;
+};
+
+// Histogram of latencies in nanoseconds with a bounded relative error, as HDR histograms do:
+// values below 16 have their own bucket, and each power of 2 range above is split in 16
+// buckets, so a bucket is at most 1/16 (6.25%) of its values wide. Covers up to 2^40 ns (18 min);
+// longer latencies are counted in the last bucket. Fixed size: 4.7 KB.
+class LatencyHistogram {
+    public:
+        static const int subBuckets = 16;
+        static const int bucketCount = (40 - 3) * subBuckets;
+
+        LatencyHistogram() { reset(); }
+
+        void record(uint64_t ns);
+        // Add the values recorded by other.
+        void merge(const LatencyHistogram& other);
+        void reset();
+
+        uint64_t count() const { return total; }
+        uint64_t min() const { return total ? minimum : 0; }
+        uint64_t max() const { return maximum; }
+        double mean() const { return total ? (double)sum / total : 0; }
+
+        // Return the latency that a fraction q (0 to 1) of the values do not exceed, within the
+        // width of a bucket (rounded up, and never above max()). 0 if nothing was recorded.
+        uint64_t percentile(double q) const;
+
+        // Buckets, for export: bucket i (0 to bucketCount - 1) holds bucketValues(i) latencies
+        // from bucketLow(i) to bucketHigh(i) ns.
+        uint64_t bucketValues(int i) const { return buckets[i]; }
+        static uint64_t bucketLow(int i);
+        static uint64_t bucketHigh(int i) { return i + 1 < bucketCount ? bucketLow(i + 1) - 1 : UINT64_MAX; }
+
+    private:
+        static int bucketOf(uint64_t ns);
+
+        uint64_t buckets[bucketCount];
+        uint64_t total;
+        uint64_t sum;
+        uint64_t minimum;
+        uint64_t maximum;
+};
+
+inline int LatencyHistogram::bucketOf(uint64_t ns){
+    if(ns < (uint64_t)subBuckets)
+        return (int)ns;
+    // Position of the highest bit set, at least 4.
+#if defined(__GNUC__) || defined(__clang__)
+    int exponent = 63 - __builtin_clzll(ns);
+#else
+    int exponent = 4;
+    while(ns >> (exponent + 1))
+        exponent++;
+#endif
+    int index = (exponent - 3) * subBuckets + (int)((ns >> (exponent - 4)) & (subBuckets - 1));
+    return std::min(index, bucketCount - 1);
+}
+
+inline uint64_t LatencyHistogram::bucketLow(int i){
+    if(i < subBuckets)
+        return i;
+    int exponent = i / subBuckets + 3;
+    return (uint64_t)(subBuckets + i % subBuckets) << (exponent - 4);
+}
+
+inline void LatencyHistogram::record(uint64_t ns){
+    buckets[bucketOf(ns)]++;
+    total++;
+    sum += ns;
+    minimum = std::min(minimum, ns);
+    maximum = std::max(maximum, ns);
+}
+
+inline void LatencyHistogram::merge(const LatencyHistogram& other){
+    for(int i = 0; i < bucketCount; i++)
+        buckets[i] += other.buckets[i];
+    total += other.total;
+    sum += other.sum;
+    minimum = std::min(minimum, other.minimum);
+    maximum = std::max(maximum, other.maximum);
+}
+
+inline void LatencyHistogram::reset(){
+    fill(buckets, buckets + bucketCount, 0);
+    total = sum = maximum = 0;
+    minimum = UINT64_MAX;
+}
+
+inline uint64_t LatencyHistogram::percentile(double q) const{
+    if(total == 0)
+        return 0;
+    // Rank of the value wanted, from 1 to total.
+    uint64_t rank = std::max((uint64_t)1, (uint64_t)ceil(std::min(std::max(q, 0.0), 1.0) * total));
+    uint64_t seen = 0;
+    for(int i = 0; i < bucketCount; i++){
+        seen += buckets[i];
+        if(seen >= rank)
+            return std::min(bucketHigh(i), maximum);
+    }
+    return maximum;
+}
+
+// Statistics of one method.
+struct MethodStats {
+    uint64_t calls;
+    // Summed over the calls.
+    SearchCallCounts totals;
+    // Largest number of probes made by one call.
+    uint64_t maxProbes;
+    LatencyHistogram latency;
+
+    MethodStats() { reset(); }
+
+    void reset();
+    void merge(const MethodStats& other);
+    void record(const SearchCallCounts& call, uint64_t ns);
+
+    // Averages per call.
+    double probesPerCall() const { return calls ? (double)totals.probes / calls : 0; }
+    double comparisonsPerCall() const { return calls ? (double)totals.comparisons / calls : 0; }
+    double iterationsPerCall() const { return calls ? (double)totals.iterations / calls : 0; }
+};
+
+inline void MethodStats::reset(){
+    calls = 0;
+    totals = SearchCallCounts{0, 0, 0};
+    maxProbes = 0;
+    latency.reset();
+}
+
+inline void MethodStats::merge(const MethodStats& other){
+    calls += other.calls;
+    totals.probes += other.totals.probes;
+    totals.comparisons += other.totals.comparisons;
+    totals.iterations += other.totals.iterations;
+    maxProbes = std::max(maxProbes, other.maxProbes);
+    latency.merge(other.latency);
+}
+
+inline void MethodStats::record(const SearchCallCounts& call, uint64_t ns){
+    calls++;
+    totals.probes += call.probes;
+    totals.comparisons += call.comparisons;
+    totals.iterations += call.iterations;
+    maxProbes = std::max(maxProbes, call.probes);
+    latency.record(ns);
+}
+
+// Statistics of every method of one SearchingAlgo instance.
+struct SearchStats {
+    MethodStats methods[statsMethodCount];
+    // Counts of the call in progress.
+    SearchCallCounts call;
+
+    SearchStats() : call() {}
+
+    void reset(){
+        for(int m = 0; m < statsMethodCount; m++)
+            methods[m].reset();
+    }
+
+    // Add the statistics of other, e.g. to sum those of the instances used by several threads.
+    void merge(const SearchStats& other){
+        for(int m = 0; m < statsMethodCount; m++)
+            methods[m].merge(other.methods[m]);
+    }
+};
+
+// Times one call and adds its counts to the statistics of its method when it ends. The counts
+// of the call in progress when it starts, if any, are set aside, and the counts of this call
+// added to them at the end, so that a caller includes the searches it runs.
+class SearchStatsScope {
+    public:
+        SearchStatsScope(SearchStats& stats, StatsMethod method) : stats(stats), method(method), outer(stats.call){
+            stats.call = SearchCallCounts{0, 0, 0};
+            start = chrono::steady_clock::now();
+        }
+
+        ~SearchStatsScope(){
+            uint64_t ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+            stats.methods[method].record(stats.call, ns);
+            stats.call.probes += outer.probes;
+            stats.call.comparisons += outer.comparisons;
+            stats.call.iterations += outer.iterations;
+        }
+
+    private:
+        SearchStatsScope(const SearchStatsScope&);
+        SearchStatsScope& operator=(const SearchStatsScope&);
+
+        SearchStats& stats;
+        StatsMethod method;
+        SearchCallCounts outer;
+        chrono::steady_clock::time_point start;
+};
+
+// Counting macros used in the searches; statistics is the SearchStats member of SearchingAlgo.
+// SEARCH_STATS_BEGIN(method): start timing a call of method, until the end of the block.
+// SEARCH_STATS_ADD(counter, n): add n to counter (probes, comparisons or iterations) of the call.
+// SEARCH_STATS_PROBE(comparison): evaluate comparison of a newly read element with the item,
+// counting a probe and a comparison. SEARCH_STATS_COMPARE(comparison): the same, for an
+// element already read, counting a comparison only.
+#ifdef SEARCHINGALGO_INSTRUMENT
+#define SEARCH_STATS_BEGIN(method) SearchStatsScope searchStatsScope(statistics, method)
+#define SEARCH_STATS_ADD(counter, n) (statistics.call.counter += (n))
+#define SEARCH_STATS_PROBE(comparison) (statistics.call.probes++, statistics.call.comparisons++, (comparison))
+#define SEARCH_STATS_COMPARE(comparison) (statistics.call.comparisons++, (comparison))
+#else
+#define SEARCH_STATS_BEGIN(method) ((void)0)
+#define SEARCH_STATS_ADD(counter, n) ((void)0)
+#define SEARCH_STATS_PROBE(comparison) (comparison)
+#define SEARCH_STATS_COMPARE(comparison) (comparison)
+#endif
+
+#endif // SEARCHSTATS_H
@@ -2,18 +2,127 @@
 #define SEARCHINGALGO_H
 
 #include <list>
+#include <vector>
 #include <iostream>
 #include <cmath>
+#include <cstddef>
+#include <utility>
+#include <type_traits>
+#include <SimdSearch.h>
+#include <SequenceSearch.h>
+#include <MultiSequenceSearch.h>
+#include <LookupCache.h>
+#include <BloomFilter.h>
+#include <SearchStats.h>
 using namespace std;
 
+// Hint the CPU to start loading the cache line of addr before it is needed.
+// Does nothing on compilers without a prefetch builtin.
+inline void searchPrefetch(const void* addr){
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(addr);
+#else
+    (void)addr;
+#endif
+}
+
+// Result of a search for a single key.
+// found: true if the key is in the array.
+// position: index of the first element not less than the key (its insertion point if not found).
+struct SearchResult {
+    bool found;
+    size_t position;
+};
+
+// Non-owning view of consecutive elements of a sorted array, returned by the range queries of
+// SearchingAlgo. Valid as long as the array is; iterates like a container.
+template <class Type>
+struct RangeView {
+    const Type* first;
+    const Type* last;
+    // Index of first in the array searched.
+    size_t offset;
+
+    const Type* begin() const { return first; }
+    const Type* end() const { return last; }
+    size_t size() const { return last - first; }
+    bool empty() const { return first == last; }
+    const Type& operator[](size_t i) const { return first[i]; }
+};
+
+// Sorted array searching methods that can report positions (see SearchingAlgo::lowerBound).
+enum SearchMethod {
+    searchBinary,
+    searchExponential,
+    searchFibonacci,
+    searchInterpolation,
+    searchJump
+};
+
+// How binarySearch and fibonacciSearch compare elements with the item.
+// compareBranching: three-way comparison at each step, stopping as soon as the item is found.
+// compareBranchless: two-way comparison whose outcome only selects the next range with a
+// conditional move, and a single equality check at the end. Always takes the full O(log n)
+// steps, but has no branch to mispredict; faster on random keys while the array is in cache.
+enum CompareMode {
+    compareBranching,
+    compareBranchless
+};
+
+// Return the name of method, e.g. "binary" for searchBinary.
+inline const char* searchMethodName(SearchMethod method){
+    switch(method){
+        case searchBinary: return "binary";
+        case searchExponential: return "exponential";
+        case searchFibonacci: return "fibonacci";
+        case searchInterpolation: return "interpolation";
+        case searchJump: return "jump";
+    }
+    return "unknown";
+}
+
 // Class Template
 template <class Type>
 class SearchingAlgo {
     public:
+        // mode: comparison used by binarySearch and fibonacciSearch of this instance.
+        SearchingAlgo(CompareMode mode = compareBranching) : mode(mode), cache(0), filter(0) {}
+
+        CompareMode compareMode() const { return mode; }
+        void setCompareMode(CompareMode mode) { this->mode = mode; }
+
+        // Attach cache in front of binarySearch, jumpSearch, interpolationSearch, exponentialSearch
+        // and fibonacciSearch: their results are looked up in the cache first, and stored there
+        // after a search. The cache is not owned and may be shared by several instances; 0 detaches it.
+        // Pays off when a few hot keys make most of the lookups. Call cache->clear() after changing
+        // the contents of a searched array.
+        void setLookupCache(LookupCache<Type>* cache) { this->cache = cache; }
+        LookupCache<Type>* lookupCache() const { return cache; }
+
+        // Attach filter in front of every single key search (linear, binary, jump, interpolation,
+        // exponential, fibonacci and recursive linear): searches of the array the filter was built
+        // from return false without touching the array when the filter rejects the key, before the
+        // lookup cache is consulted. Searches of other arrays ignore the filter. Pays off when most
+        // lookups are misses. The filter is not owned; 0 detaches it.
+        void setBloomFilter(const BloomFilter<Type>* filter) { this->filter = filter; }
+        const BloomFilter<Type>* bloomFilter() const { return filter; }
+
+        // Probe, comparison and iteration counts and latency histograms of the searches of this
+        // instance (see SearchStats.h), for the searches that reach the array: those answered by
+        // the Bloom filter or the lookup cache are not counted.
+        // Only collected when compiled with SEARCHINGALGO_INSTRUMENT defined, which instrumented()
+        // tells; stats() is all zero otherwise. Every search then writes the statistics, so an
+        // instrumented instance must not search from several threads at once.
+        static bool instrumented();
+        // Return a copy of the statistics collected since the creation or the last resetStats().
+        SearchStats stats() const;
+        void resetStats();
+
         // This method performs linear search on the item passed to the function.
         // arrList: array used for the searching of the item.
         // num: number of elements in arrList.
         // Worst case complexity: O(n) where n is the number of elements in arrList.
+        // 32/64-bit integers, float and double are compared 8 to 32 elements at a time with SIMD instructions.
         bool linearSearch(Type arrList[], int num, const Type& item);
 
         // Perform binary search on sorted array.
@@ -23,6 +132,13 @@ class SearchingAlgo {
         // Time Complexity: O(log n)
         bool binarySearch(Type arrListSorted[], int num, const Type& item);
 
+        // Perform binary search for nkeys keys at the same time on sorted array.
+        // The keys are walked through the search in groups, one level per step, and the
+        // next probe of every key is prefetched so that cache misses of different keys overlap.
+        // results[i] receives the found flag and lower bound position of keys[i].
+        // Time Complexity: O(k log n) where k is nkeys.
+        void binarySearchBatch(Type arrListSorted[], int num, const Type keys[], int nkeys, SearchResult results[]);
+
         // Perform jump search whereby the comparison is made by jumping
         // ahead by a fixed number of steps through the array.
         // The array needs to be sorted.
@@ -31,7 +147,10 @@ class SearchingAlgo {
 
         // Interpolation search works well with sorted, uniformly distributed values of arrListSorted.
         // Improvement over binarySearch.
-        // Time complexity: O(log log n)
+        // Whenever a probe fails to halve the remaining range, the next step is a binary search step,
+        // and after a few probes only binary search steps are taken, so skewed data costs at most O(log n).
+        // 64-bit integer probes are computed exactly; types that are not arithmetic always take the middle.
+        // Time complexity: O(log log n) on uniform data, O(log n) worst case.
         bool interpolationSearch(Type arrListSorted[], int num, const Type& item);
 
         // Exponential Search needs sorted array as well.
@@ -42,9 +161,22 @@ class SearchingAlgo {
 
         // Sublist search is used to compare 2 lists, namely list_1 (longer list) and list_2 (sublist).
         // If list_1 contains list_2, then true is returned; false otherwise.
-        // Time complexity: O(m*n) where m is the number of nodes in second list and n in first list.
+        // The lists are matched with SequenceMatcher (Knuth-Morris-Pratt) in a single pass over list_1.
+        // Time complexity: O(m+n) where m is the number of nodes in second list and n in first list.
         bool sublistSearch(list<Type>& largeList, list<Type>& smallList);
 
+        // Sublist search of many small lists at once.
+        // Returns, for each list in smallLists, whether largeList contains it.
+        // The small lists are compiled into one MultiSequenceMatcher (Aho-Corasick automaton),
+        // so largeList is scanned once instead of once per small list.
+        // Time complexity: O(n log s + L*s) where L is the total length of smallLists and s the number of distinct elements in them.
+        vector<bool> multiSublistSearch(list<Type>& largeList, vector<list<Type> >& smallLists);
+
+        // Return the offsets of every occurrence of pattern (patternSize elements) in arrList,
+        // in ascending order. Occurrences may overlap.
+        // Time complexity: O(m+n)
+        vector<size_t> sequenceSearch(const Type arrList[], size_t num, const Type pattern[], size_t patternSize);
+
         // Algorithm:
         // 1. Find the smallest fibonacci number (fib) greater than or equals to num.
         // (Find the corresponding fib_1 and fib_2) while fib > 1
@@ -61,37 +193,205 @@ class SearchingAlgo {
         bool recursiveLinearSearch(Type arrList[], int num, const Type& item);
 
         // Perform recursive sublist search.
+        // Kept for compatibility: recursing once per node overflowed the stack on long lists,
+        // so it now runs the same single pass matcher as sublistSearch.
         bool recursiveSublistSearch(list<Type>& largeList, list<Type>& smallList);
 
+        // Position-returning searches on sorted array.
+        // They use size_t indexing, so arrays may hold more than 2^31 elements.
+        // method selects the algorithm used to walk the array; all of them give the same answer.
+
+        // Return the index of the first element not less than item, or num if there is none.
+        size_t lowerBound(const Type arrListSorted[], size_t num, const Type& item, SearchMethod method = searchBinary);
+
+        // Return the index of the first element greater than item, or num if there is none.
+        size_t upperBound(const Type arrListSorted[], size_t num, const Type& item, SearchMethod method = searchBinary);
+
+        // Return the range [first, second) of elements equal to item.
+        // The range is empty (first == second) and first is the insertion point if item is not found.
+        pair<size_t, size_t> equalRange(const Type arrListSorted[], size_t num, const Type& item, SearchMethod method = searchBinary);
+
+        // Return the index of the first element equal to item, or num if there is none.
+        size_t findPosition(const Type arrListSorted[], size_t num, const Type& item, SearchMethod method = searchBinary);
+
+        // Range queries on sorted array: the elements x with lo <= x <= hi, as a view of the array.
+        // Nothing is copied or allocated. The range is empty if hi < lo.
+
+        // Both bounds are found in one descent: a binary search narrows the part of the array that
+        // holds both bounds until an element falls in [lo, hi]; from there the lower bound is
+        // searched on the left, and the upper bound galloped to on the right, as exponentialSearch
+        // does, so that short ranges cost few more probes than a single search.
+        // Time complexity: O(log n)
+        RangeView<Type> rangeQuery(const Type arrListSorted[], size_t num, const Type& lo, const Type& hi);
+
+        // Return the number of elements x with lo <= x <= hi.
+        size_t countInRange(const Type arrListSorted[], size_t num, const Type& lo, const Type& hi);
+
+        // Answer nqueries range queries: results[i] receives rangeQuery() of [lows[i], highs[i]].
+        // A query whose lo is not below the lo of the previous one gallops from where the previous
+        // range started, so that queries sorted by lo cost O(log d) each for a distance d between
+        // consecutive ranges, instead of O(log n).
+        void rangeQueryBatch(const Type arrListSorted[], size_t num, const Type lows[], const Type highs[], size_t nqueries, RangeView<Type> results[]);
+
+        // Nearest key searches on sorted array, for floating point data where exact matches are rare.
+        // They descend the array as lowerBound does with method, then look at the neighbours of
+        // the lower bound. The distance of x to item is |x - item|; of two elements at the same
+        // distance, the smaller is the nearer. item and the elements must not be NaN.
+
+        // Return the index of the element nearest to item, or num if the array is empty.
+        // Time complexity: that of method, e.g. O(log n) for searchBinary.
+        size_t nearestSearch(const Type arrListSorted[], size_t num, const Type& item, SearchMethod method = searchBinary);
+
+        // Return the k elements nearest to item (the whole array if num <= k), as a view of the
+        // array: they are always consecutive. Nothing is copied or allocated.
+        // Time complexity: that of method, plus O(log k).
+        RangeView<Type> kNearestSearch(const Type arrListSorted[], size_t num, const Type& item, size_t k, SearchMethod method = searchBinary);
+
+        // Return the elements x with item - tolerance <= x <= item + tolerance, as rangeQuery() does.
+        // item - tolerance and item + tolerance must not overflow Type.
+        RangeView<Type> toleranceSearch(const Type arrListSorted[], size_t num, const Type& item, const Type& tolerance);
+
+        // Return true if an element lies within tolerance of item: the fuzzy binarySearch.
+        bool approximateSearch(const Type arrListSorted[], size_t num, const Type& item, const Type& tolerance, SearchMethod method = searchBinary);
+
+        // Answer nitems nearest searches: results[i] receives nearestSearch() of items[i].
+        // The binary searches of the items run side by side, 16 at a time, one per vector lane
+        // for float and double on AVX2 processors (see simdLowerBounds()), so that their cache
+        // misses overlap; other types and processors take the same steps one item at a time.
+        // Time complexity: O(k log n) where k is nitems.
+        void nearestSearchBatch(const Type arrListSorted[], size_t num, const Type items[], size_t nitems, size_t results[]);
+
     private:
+        // Return the number of leading elements of arrListSorted for which inPrefix is true,
+        // using the algorithm selected by method. inPrefix must be true for a prefix of the array
+        // and false for the rest, and item must lie between the two parts.
+        template <class Predicate>
+        size_t partitionPoint(const Type arrListSorted[], size_t num, const Type& item, Predicate inPrefix, SearchMethod method);
+        template <class Predicate>
+        size_t binaryPartition(const Type arrListSorted[], size_t first, size_t last, Predicate inPrefix);
+        template <class Predicate>
+        size_t exponentialPartition(const Type arrListSorted[], size_t num, Predicate inPrefix);
+        template <class Predicate>
+        size_t fibonacciPartition(const Type arrListSorted[], size_t num, Predicate inPrefix);
+        template <class Predicate>
+        size_t interpolationPartition(const Type arrListSorted[], size_t num, const Type& item, Predicate inPrefix);
+        template <class Predicate>
+        size_t jumpPartition(const Type arrListSorted[], size_t num, Predicate inPrefix);
+
+        // How interpolationProbe() estimates positions for Type: 2 for exact integer arithmetic,
+        // 1 for floating point, 0 for types that are not arithmetic.
+        typedef integral_constant<int, is_integral<Type>::value ? 2 : is_floating_point<Type>::value ? 1 : 0> InterpolationKind;
+
+        // Estimate the position of item between first and last (inclusive) from their values.
+        // Types that are not arithmetic take the middle, as binary search does.
+        size_t interpolationProbe(const Type arrListSorted[], size_t first, size_t last, const Type& item, integral_constant<int, 2>);
+        size_t interpolationProbe(const Type arrListSorted[], size_t first, size_t last, const Type& item, integral_constant<int, 1>);
+        size_t interpolationProbe(const Type arrListSorted[], size_t first, size_t last, const Type& item, integral_constant<int, 0>);
+
+        // Number of interpolation probes tried on num elements before switching to plain bisection.
+        // Interpolation needs about log log n probes on uniform data, so a few more than that.
+        static int interpolationProbeLimit(size_t num);
+
+        // Distances between elements: unsigned for integers, so that they never overflow.
+        typedef typename conditional<is_integral<Type>::value, make_unsigned<Type>, common_type<Type> >::type::type Distance;
+
+        // Return high - low, for low <= high.
+        static Distance keyDistance(const Type& low, const Type& high);
+
+        // Return the index of the element nearest to item, given pos, its lower bound.
+        size_t nearestOf(const Type arrListSorted[], size_t num, const Type& item, size_t pos);
+
         bool recursiveLinearSearch(Type arrList[], int startIn, int endIn, const Type& item);
-        bool recursiveSublistSearch(list<Type>& largeList, typename list<Type>::iterator largeIt, typename list<Type>::iterator startLoc, list<Type>& smallList,
-                                    typename list<Type>::iterator smallIt);
 
+        // binarySearch and fibonacciSearch with compareBranchless.
+        bool branchlessBinarySearch(const Type arrListSorted[], size_t num, const Type& item);
+        bool branchlessFibonacciSearch(const Type arrListSorted[], size_t num, const Type& item);
+
+        // binarySearch, jumpSearch, interpolationSearch, exponentialSearch and fibonacciSearch
+        // without the Bloom filter and the lookup cache.
+        bool uncachedBinarySearch(Type arrListSorted[], int num, const Type& item);
+        bool uncachedJumpSearch(Type arrListSorted[], int num, const Type& item);
+        bool uncachedInterpolationSearch(Type arrListSorted[], int num, const Type& item);
+        bool uncachedExponentialSearch(Type arrList[], int num, const Type& item);
+        bool uncachedFibonacciSearch(Type arrListSorted[], int num, const Type& item);
+
+        // Return false if the Bloom filter rejects item, else the result of
+        // (this->*search)(arrListSorted, num, item) from the lookup cache, or run search, one of
+        // the uncached searches, and store its result in the cache. The filter and the cache are
+        // only read here and left attached, so that search may throw, or a search nested in a
+        // comparison use them too.
+        bool filteredSearch(Type arrListSorted[], int num, const Type& item, bool (SearchingAlgo::*search)(Type[], int, const Type&));
+
+        CompareMode mode;
+        LookupCache<Type>* cache;
+        const BloomFilter<Type>* filter;
+#ifdef SEARCHINGALGO_INSTRUMENT
+        SearchStats statistics;
+#endif
 };
 
 template <class Type>
 bool SearchingAlgo<Type>::linearSearch(Type arrList[], int num, const Type& item){
+    if(filter && filter->rejects(arrList, num, item))
+        return false;
+    SEARCH_STATS_BEGIN(statsLinear);
+    if(num <= 0)
+        return false;
     // Linearly compare each element in arrList with item starting from the first item.
-    for(int i = 0; i < num; i++){
-        if(arrList[i] == item)
-            return true;
-    }
+    // simdFind() falls back to a plain loop when Type has no vectorized kernel.
+    size_t pos = simdFind(arrList, (size_t)num, item);
+    SEARCH_STATS_ADD(probes, min(pos + 1, (size_t)num));
+    SEARCH_STATS_ADD(comparisons, min(pos + 1, (size_t)num));
+    SEARCH_STATS_ADD(iterations, min(pos + 1, (size_t)num));
+    return pos < (size_t)num;
+}
+
+template <class Type>
+bool SearchingAlgo<Type>::instrumented(){
+#ifdef SEARCHINGALGO_INSTRUMENT
+    return true;
+#else
     return false;
+#endif
+}
+
+template <class Type>
+SearchStats SearchingAlgo<Type>::stats() const{
+#ifdef SEARCHINGALGO_INSTRUMENT
+    return statistics;
+#else
+    return SearchStats();
+#endif
+}
+
+template <class Type>
+void SearchingAlgo<Type>::resetStats(){
+#ifdef SEARCHINGALGO_INSTRUMENT
+    statistics.reset();
+#endif
 }
 
 template <class Type>
 bool SearchingAlgo<Type>::binarySearch(Type arrListSorted[], int num, const Type& item){
+    return filteredSearch(arrListSorted, num, item, &SearchingAlgo::uncachedBinarySearch);
+}
+
+template <class Type>
+bool SearchingAlgo<Type>::uncachedBinarySearch(Type arrListSorted[], int num, const Type& item){
+    SEARCH_STATS_BEGIN(statsBinary);
+    if(mode == compareBranchless)
+        return num > 0 && branchlessBinarySearch(arrListSorted, num, item);
     if(num > 0){
         int begIndex = 0, lastIndex = num - 1;
         while(begIndex <= lastIndex){
             // get index of middle element.
             int middleIndex = (begIndex + lastIndex) / 2;
+            SEARCH_STATS_ADD(iterations, 1);
             // if arrListSorted[middleIndex] is greater than item, the element to be search might be at the left subarray..
-            if(arrListSorted[middleIndex] > item)
+            if(SEARCH_STATS_PROBE(arrListSorted[middleIndex] > item))
                 lastIndex = middleIndex - 1;
             // if arrListSorted[middleIndex] is less than item, the element to be search might be at the right subarray..
-            else if(arrListSorted[middleIndex] < item)
+            else if(SEARCH_STATS_COMPARE(arrListSorted[middleIndex] < item))
                 begIndex = middleIndex + 1;
             // if match.
             else
@@ -102,8 +402,134 @@ bool SearchingAlgo<Type>::binarySearch(Type arrListSorted[], int num, const Type
     return false;
 }
 
+template <class Type>
+bool SearchingAlgo<Type>::filteredSearch(Type arrListSorted[], int num, const Type& item, bool (SearchingAlgo::*search)(Type[], int, const Type&)){
+    if(filter && filter->rejects(arrListSorted, num, item))
+        return false;
+    if(!cache)
+        return (this->*search)(arrListSorted, num, item);
+    bool found;
+    if(cache->lookup(arrListSorted, num, item, found))
+        return found;
+    found = (this->*search)(arrListSorted, num, item);
+    cache->insert(arrListSorted, num, item, found);
+    return found;
+}
+
+template <class Type>
+bool SearchingAlgo<Type>::branchlessBinarySearch(const Type arrListSorted[], size_t num, const Type& item){
+    // base is the last element not greater than item, if there is one, among the length
+    // elements starting at base. Each step keeps one half of them, chosen without a branch.
+    const Type* base = arrListSorted;
+    size_t length = num;
+    while(length > 1){
+        size_t half = length / 2;
+        // Without a branch the CPU cannot load ahead speculatively, so fetch both possible next probes.
+        searchPrefetch(base + half / 2);
+        searchPrefetch(base + half + half / 2);
+        SEARCH_STATS_ADD(iterations, 1);
+        base = SEARCH_STATS_PROBE(item < base[half]) ? base : base + half;
+        length -= half;
+    }
+    return SEARCH_STATS_PROBE(*base == item);
+}
+
+template <class Type>
+bool SearchingAlgo<Type>::branchlessFibonacciSearch(const Type arrListSorted[], size_t num, const Type& item){
+    size_t fibN_1 = 1;
+    size_t fibN_2 = 0;
+    size_t fib = fibN_1 + fibN_2;
+
+    // Determine the smallest fibonacci number greater or equal to num.
+    while(fib < num){
+        fibN_2 = fibN_1;
+        fibN_1 = fib;
+        fib = fibN_1 + fibN_2;
+    }
+
+    // Number of leading elements known to be not greater than item.
+    size_t offset = 0;
+
+    while(fib > 1){
+        size_t index = min(offset + fibN_2, num) - 1;
+        // Fetch both possible next probes, as in branchlessBinarySearch.
+        searchPrefetch(arrListSorted + min(index + fibN_1 - fibN_2, num - 1));
+        searchPrefetch(arrListSorted + min(offset + 2 * fibN_2 - fibN_1 - 1, num - 1));
+        // One step down the fibonacci sequence if the element is not greater than item,
+        // two steps down otherwise. Both outcomes are computed and one is selected.
+        // The selection is done with a mask, since compilers turn plain ?: back into branches here.
+        SEARCH_STATS_ADD(iterations, 1);
+        size_t mask = 0 - (size_t)!SEARCH_STATS_PROBE(item < arrListSorted[index]);
+        size_t nextN_1 = ((fibN_1 - fibN_2) & ~mask) | (fibN_2 & mask);
+        fib = (fibN_2 & ~mask) | (fibN_1 & mask);
+        fibN_1 = nextN_1;
+        fibN_2 = fib - fibN_1;
+        offset = (offset & ~mask) | ((index + 1) & mask);
+    }
+
+    // There might be one element left to compare.
+    if(fib && offset < num)
+        offset += !SEARCH_STATS_PROBE(item < arrListSorted[offset]);
+    return offset > 0 && SEARCH_STATS_PROBE(arrListSorted[offset - 1] == item);
+}
+
+template <class Type>
+void SearchingAlgo<Type>::binarySearchBatch(Type arrListSorted[], int num, const Type keys[], int nkeys, SearchResult results[]){
+    SEARCH_STATS_BEGIN(statsBinaryBatch);
+    // Number of keys walked through the search together.
+    const int groupSize = 16;
+
+    for(int first = 0; first < nkeys; first += groupSize){
+        int count = min(groupSize, nkeys - first);
+
+        if(num <= 0){
+            for(int k = 0; k < count; k++)
+                results[first + k] = SearchResult{false, 0};
+            continue;
+        }
+
+        // Start of the remaining range for each key. All keys share the same range length,
+        // so the loop runs the same number of steps for every key in the group.
+        size_t base[groupSize];
+        for(int k = 0; k < count; k++)
+            base[k] = 0;
+
+        size_t length = num;
+        while(length > 1){
+            size_t half = length / 2;
+            // Prefetch both possible probes of the next step before comparing.
+            for(int k = 0; k < count; k++){
+                searchPrefetch(&arrListSorted[base[k] + half / 2]);
+                searchPrefetch(&arrListSorted[base[k] + half + half / 2]);
+            }
+            // Move to the right half if the middle element is less than the key.
+            for(int k = 0; k < count; k++)
+                base[k] = (arrListSorted[base[k] + half] < keys[first + k]) ? base[k] + half : base[k];
+            length -= half;
+            SEARCH_STATS_ADD(iterations, count);
+            SEARCH_STATS_ADD(probes, count);
+            SEARCH_STATS_ADD(comparisons, count);
+        }
+
+        // base[k] now points to the last element less than the key, or to the lower bound itself.
+        for(int k = 0; k < count; k++){
+            size_t pos = base[k] + (arrListSorted[base[k]] < keys[first + k]);
+            bool found = pos < (size_t)num && !(keys[first + k] < arrListSorted[pos]);
+            results[first + k] = SearchResult{found, pos};
+            SEARCH_STATS_ADD(probes, 1 + (pos < (size_t)num));
+            SEARCH_STATS_ADD(comparisons, 1 + (pos < (size_t)num));
+        }
+    }
+}
+
 template <class Type>
 bool SearchingAlgo<Type>::jumpSearch(Type arrListSorted[], int num, const Type& item){
+    return filteredSearch(arrListSorted, num, item, &SearchingAlgo::uncachedJumpSearch);
+}
+
+template <class Type>
+bool SearchingAlgo<Type>::uncachedJumpSearch(Type arrListSorted[], int num, const Type& item){
+    SEARCH_STATS_BEGIN(statsJump);
     if(num > 0){
         // To keep track of previous index after jumping.
         int prev = 0;
@@ -113,11 +539,12 @@ bool SearchingAlgo<Type>::jumpSearch(Type arrListSorted[], int num, const Type&
         int jumpLoc = step;
 
         // min() function is used to ensure that the index is in bound.
-        while(arrListSorted[min(jumpLoc, num) - 1] < item){
+        while(SEARCH_STATS_PROBE(arrListSorted[min(jumpLoc, num) - 1] < item)){
             // If the statement is true, all the values in arrListSorted is smaller than the item.
             if(jumpLoc >= num)
                 return false;
 
+            SEARCH_STATS_ADD(iterations, 1);
             prev = jumpLoc;
             jumpLoc += step;
         }
@@ -126,51 +553,72 @@ bool SearchingAlgo<Type>::jumpSearch(Type arrListSorted[], int num, const Type&
             jumpLoc = num;
 
         // Linear search is performed within the range of ((n-1)*m)th and (n*m - 1)th.
-        while(prev <= jumpLoc - 1){
-            if(arrListSorted[prev] == item)
-                return true;
-            prev++;
-        }
-        return false;
+        size_t blockSize = jumpLoc - prev;
+        size_t pos = simdFind(arrListSorted + prev, blockSize, item);
+        SEARCH_STATS_ADD(probes, min(pos + 1, blockSize));
+        SEARCH_STATS_ADD(comparisons, min(pos + 1, blockSize));
+        return pos < blockSize;
     }
     return false;
 }
 
 template <class Type>
 bool SearchingAlgo<Type>::interpolationSearch(Type arrListSorted[], int num, const Type& item){
-    int begIndex = 0;
-    int lastIndex = num - 1;
-    // Determine the position of element to be compared.
-    int pos = begIndex
-            + (double)(item - arrListSorted[begIndex])
-            / (arrListSorted[lastIndex] - arrListSorted[begIndex])
-            * (lastIndex - begIndex);
-
-    // To ensure pos is within the range of arrListSorted.
-    while(begIndex <= pos && pos <= lastIndex){
-        if(arrListSorted[pos] < item)
+    return filteredSearch(arrListSorted, num, item, &SearchingAlgo::uncachedInterpolationSearch);
+}
+
+template <class Type>
+bool SearchingAlgo<Type>::uncachedInterpolationSearch(Type arrListSorted[], int num, const Type& item){
+    SEARCH_STATS_BEGIN(statsInterpolation);
+    if(num <= 0)
+        return false;
+
+    // Range of elements still to be searched, [begIndex, endIndex).
+    size_t begIndex = 0, endIndex = num;
+    // Interpolation probes left before only bisection is used.
+    int probesLeft = interpolationProbeLimit(num);
+    // Set after an interpolation probe that failed to halve the range.
+    bool bisect = false;
+
+    while(begIndex < endIndex){
+        size_t oldSize = endIndex - begIndex;
+        // Determine the position of element to be compared.
+        size_t pos;
+        if(bisect || probesLeft <= 0)
+            pos = begIndex + oldSize / 2;
+        else{
+            pos = interpolationProbe(arrListSorted, begIndex, endIndex - 1, item, InterpolationKind());
+            probesLeft--;
+        }
+
+        SEARCH_STATS_ADD(iterations, 1);
+        if(SEARCH_STATS_PROBE(arrListSorted[pos] < item))
             begIndex = pos + 1;
-        else if(arrListSorted[pos] > item)
-            lastIndex = pos - 1;
+        else if(SEARCH_STATS_COMPARE(item < arrListSorted[pos]))
+            endIndex = pos;
         else
             return true;
 
-        pos = begIndex
-            + static_cast<double>(item - arrListSorted[begIndex])
-            / (arrListSorted[lastIndex] - arrListSorted[begIndex])
-            * (lastIndex - begIndex);
+        bisect = !bisect && endIndex - begIndex > oldSize / 2;
     }
     return false;
 }
 
 template <class Type>
 bool SearchingAlgo<Type>::exponentialSearch(Type arrList[], int num, const Type& item){
+    return filteredSearch(arrList, num, item, &SearchingAlgo::uncachedExponentialSearch);
+}
+
+template <class Type>
+bool SearchingAlgo<Type>::uncachedExponentialSearch(Type arrList[], int num, const Type& item){
+    SEARCH_STATS_BEGIN(statsExponential);
     if(num > 0){
         int index = 1;
         // Determine the position of element where its value is greater or equal to item.
-        while(arrList[min(index, num) - 1] < item){
+        while(SEARCH_STATS_PROBE(arrList[min(index, num) - 1] < item)){
             if(index > num)
                 return false;
+            SEARCH_STATS_ADD(iterations, 1);
             index *= 2;
         }
 
@@ -180,12 +628,13 @@ bool SearchingAlgo<Type>::exponentialSearch(Type arrList[], int num, const Type&
         int middle;
 
         // Binary search is performed between (index/2)th and (index-1)th element with item value.
-        while(prev <= index - 1){
+        while(prev < index){
             middle = (prev + index) / 2;
-            if(arrList[middle] < item)
+            SEARCH_STATS_ADD(iterations, 1);
+            if(SEARCH_STATS_PROBE(arrList[middle] < item))
                 prev = middle + 1;
-            else if(arrList[middle] > item)
-                index = middle - 1;
+            else if(SEARCH_STATS_COMPARE(arrList[middle] > item))
+                index = middle;
             else
                 return true;
         }
@@ -197,43 +646,51 @@ bool SearchingAlgo<Type>::exponentialSearch(Type arrList[], int num, const Type&
 
 template <class Type>
 bool SearchingAlgo<Type>::sublistSearch(list<Type>& largeList, list<Type>& smallList){
-    if(smallList.empty())
-        return true;
-    else if(largeList.size() > smallList.size()) {
-        typename list<Type>::iterator largeIt = largeList.begin();
-        typename list<Type>::iterator smallIt = smallList.begin();
-        typename list<Type>::iterator returnLargeList = largeIt;
-
-        do{
-            // If the character of smallList matches the one of largeList,
-            // continue comparing the latter character.
-            if(*largeIt == *smallIt){
-                smallIt++;
-                largeIt++;
-            }
-            // If the character of smallList doesn't match with the one in largeList,
-            // restart the comparison by setting smallIt to point to the first node/character of smallList again.
-            // Also setting largeIt to point to the second (next after the starting character of previous comparison)
-            // character of largeList.
-            else{
-                smallIt = smallList.begin();
-                largeIt = ++returnLargeList;
-            }
-        } while(largeIt != largeList.end() && smallIt != smallList.end());
+    // If smallList has larger size than largeList, it cannot be a sublist.
+    if(smallList.size() > largeList.size())
+        return false;
+    SEARCH_STATS_BEGIN(statsSublist);
+    SequenceMatcher<Type> matcher(smallList.begin(), smallList.end());
+    // The matcher reads the list up to the end of the first occurrence, or to its end.
+    size_t offset = matcher.findFirst(largeList.begin(), largeList.end());
+    SEARCH_STATS_ADD(probes, min(offset + smallList.size(), largeList.size()));
+    SEARCH_STATS_ADD(iterations, min(offset + smallList.size(), largeList.size()));
+    return smallList.empty() || offset < largeList.size();
+}
 
-        // If smallIt points to the past-the-end element of smallList,
-        // this proves that smallList is sublist of largeList.
-        if(smallIt == smallList.end())
-            return true;
-        else
-            return false;
-    }
-    // ELse if smallList has larger size than largeList, return false.
-    return false;
+template <class Type>
+vector<bool> SearchingAlgo<Type>::multiSublistSearch(list<Type>& largeList, vector<list<Type> >& smallLists){
+    SEARCH_STATS_BEGIN(statsMultiSublist);
+    // The automaton reads the whole list.
+    SEARCH_STATS_ADD(probes, largeList.size());
+    SEARCH_STATS_ADD(iterations, largeList.size());
+    vector<vector<Type> > patterns;
+    for(size_t i = 0; i < smallLists.size(); i++)
+        patterns.push_back(vector<Type>(smallLists[i].begin(), smallLists[i].end()));
+    MultiSequenceMatcher<Type> matcher(patterns);
+    return matcher.containsEach(largeList.begin(), largeList.end());
+}
+
+template <class Type>
+vector<size_t> SearchingAlgo<Type>::sequenceSearch(const Type arrList[], size_t num, const Type pattern[], size_t patternSize){
+    SEARCH_STATS_BEGIN(statsSequence);
+    SEARCH_STATS_ADD(probes, num);
+    SEARCH_STATS_ADD(iterations, num);
+    SequenceMatcher<Type> matcher(pattern, pattern + patternSize);
+    return matcher.findAll(arrList, arrList + num);
 }
 
 template <class Type>
 bool SearchingAlgo<Type>::fibonacciSearch(Type arrListSorted[], int num, const Type& item){
+    return filteredSearch(arrListSorted, num, item, &SearchingAlgo::uncachedFibonacciSearch);
+}
+
+template <class Type>
+bool SearchingAlgo<Type>::uncachedFibonacciSearch(Type arrListSorted[], int num, const Type& item){
+    SEARCH_STATS_BEGIN(statsFibonacci);
+    if(mode == compareBranchless)
+        return num > 0 && branchlessFibonacciSearch(arrListSorted, num, item);
+
     // Second value of fibonacci sequence.
     int fibN_1 = 1;
     // First value of fibonacci sequence.
@@ -252,9 +709,10 @@ bool SearchingAlgo<Type>::fibonacciSearch(Type arrListSorted[], int num, const T
 
     while(fib > 1){
         int index = min(fibN_2 + offset, num - 1);
+        SEARCH_STATS_ADD(iterations, 1);
 
         // One step down fibonacci sequence if the element pointed is less than item.
-        if(arrListSorted[index] < item){
+        if(SEARCH_STATS_PROBE(arrListSorted[index] < item)){
             fib = fibN_1;
             fibN_1 = fibN_2;
             fibN_2 = fib - fibN_1;
@@ -263,7 +721,7 @@ bool SearchingAlgo<Type>::fibonacciSearch(Type arrListSorted[], int num, const T
         }
 
         // Two steps down the fibonacci sequence if element pointed is larger than item.
-        else if(arrListSorted[index] > item){
+        else if(SEARCH_STATS_COMPARE(arrListSorted[index] > item)){
             fib = fibN_2;
             fibN_1 = fibN_1 - fibN_2;
             fibN_2 = fib - fibN_1;
@@ -276,42 +734,381 @@ bool SearchingAlgo<Type>::fibonacciSearch(Type arrListSorted[], int num, const T
 
     // Since there might be one element left in arrListSorted,
     // if the value if equal to item, return true.
-    if(fib && arrListSorted[offset+1] == item)
+    if(fib && offset + 1 < num && SEARCH_STATS_PROBE(arrListSorted[offset+1] == item))
         return true;
     return false;
 }
 
 template <class Type>
 bool SearchingAlgo<Type>::recursiveLinearSearch(Type arrList[], int num, const Type& item){
+    if(filter && filter->rejects(arrList, num, item))
+        return false;
+    SEARCH_STATS_BEGIN(statsRecursiveLinear);
     return recursiveLinearSearch(arrList, 0, num - 1, item);
 }
 
 template <class Type>
 bool SearchingAlgo<Type>::recursiveLinearSearch(Type arrList[], int startIn, int endIn, const Type& item){
-        if(startIn <= endIn)
-            return arrList[startIn] == item || recursiveLinearSearch(arrList, startIn + 1, endIn, item);
+        if(startIn <= endIn){
+            SEARCH_STATS_ADD(iterations, 1);
+            return SEARCH_STATS_PROBE(arrList[startIn] == item) || recursiveLinearSearch(arrList, startIn + 1, endIn, item);
+        }
         else
             return false;
 }
 
 template <class Type>
 bool SearchingAlgo<Type>::recursiveSublistSearch(list<Type>& largeList, list<Type>& smallList){
-    return recursiveSublistSearch(largeList, largeList.begin(), largeList.begin(), smallList, smallList.begin());
+    return sublistSearch(largeList, smallList);
 }
 
 template <class Type>
-bool SearchingAlgo<Type>::recursiveSublistSearch(list<Type>& largeList, typename list<Type>::iterator largeIt, typename list<Type>::iterator startLoc,
-                                                 list<Type>& smallList, typename list<Type>::iterator smallIt){
-    if(smallIt == smallList.end())
-        return true;
-    else if(largeIt == largeList.end())
-        return false;
-    else {
-        if(*largeIt == *smallIt)
-            return recursiveSublistSearch(largeList, ++largeIt, startLoc, smallList, ++smallIt);
+size_t SearchingAlgo<Type>::lowerBound(const Type arrListSorted[], size_t num, const Type& item, SearchMethod method){
+    SEARCH_STATS_BEGIN(statsLowerBound);
+    // Elements less than item come first.
+    return partitionPoint(arrListSorted, num, item, [&item](const Type& element){ return element < item; }, method);
+}
+
+template <class Type>
+size_t SearchingAlgo<Type>::upperBound(const Type arrListSorted[], size_t num, const Type& item, SearchMethod method){
+    SEARCH_STATS_BEGIN(statsUpperBound);
+    // Elements not greater than item come first.
+    return partitionPoint(arrListSorted, num, item, [&item](const Type& element){ return !(item < element); }, method);
+}
+
+template <class Type>
+pair<size_t, size_t> SearchingAlgo<Type>::equalRange(const Type arrListSorted[], size_t num, const Type& item, SearchMethod method){
+    SEARCH_STATS_BEGIN(statsEqualRange);
+    size_t first = lowerBound(arrListSorted, num, item, method);
+    // The upper bound is at or after the lower bound, so only the rest of the array is searched.
+    size_t last = first + upperBound(arrListSorted + first, num - first, item, method);
+    return make_pair(first, last);
+}
+
+template <class Type>
+RangeView<Type> SearchingAlgo<Type>::rangeQuery(const Type arrListSorted[], size_t num, const Type& lo, const Type& hi){
+    SEARCH_STATS_BEGIN(statsRangeQuery);
+    // Both bounds lie within [first, last].
+    size_t first = 0, last = num;
+    while(first < last){
+        size_t middle = first + (last - first) / 2;
+        SEARCH_STATS_ADD(iterations, 1);
+        if(SEARCH_STATS_PROBE(arrListSorted[middle] < lo))
+            first = middle + 1;
+        else if(SEARCH_STATS_COMPARE(hi < arrListSorted[middle]))
+            last = middle;
+        else{
+            // lo <= arrListSorted[middle] <= hi: the bounds are on each side of middle.
+            size_t lower = binaryPartition(arrListSorted, first, middle, [&lo](const Type& element){ return element < lo; });
+            size_t upper = middle + 1 + exponentialPartition(arrListSorted + middle + 1, last - middle - 1, [&hi](const Type& element){ return !(hi < element); });
+            return RangeView<Type>{arrListSorted + lower, arrListSorted + upper, lower};
+        }
+    }
+    return RangeView<Type>{arrListSorted + first, arrListSorted + first, first};
+}
+
+template <class Type>
+size_t SearchingAlgo<Type>::countInRange(const Type arrListSorted[], size_t num, const Type& lo, const Type& hi){
+    return rangeQuery(arrListSorted, num, lo, hi).size();
+}
+
+template <class Type>
+void SearchingAlgo<Type>::rangeQueryBatch(const Type arrListSorted[], size_t num, const Type lows[], const Type highs[], size_t nqueries, RangeView<Type> results[]){
+    SEARCH_STATS_BEGIN(statsRangeQueryBatch);
+    for(size_t q = 0; q < nqueries; q++){
+        if(q == 0 || lows[q] < lows[q - 1] || highs[q] < lows[q]){
+            results[q] = rangeQuery(arrListSorted, num, lows[q], highs[q]);
+            continue;
+        }
+        // Every element before the previous range is less than the previous lo, so less than lo.
+        const Type& lo = lows[q];
+        const Type& hi = highs[q];
+        size_t start = results[q - 1].offset;
+        size_t lower = start + exponentialPartition(arrListSorted + start, num - start, [&lo](const Type& element){ return element < lo; });
+        size_t upper = lower + exponentialPartition(arrListSorted + lower, num - lower, [&hi](const Type& element){ return !(hi < element); });
+        results[q] = RangeView<Type>{arrListSorted + lower, arrListSorted + upper, lower};
+    }
+}
+
+template <class Type>
+typename SearchingAlgo<Type>::Distance SearchingAlgo<Type>::keyDistance(const Type& low, const Type& high){
+    return (Distance)((Distance)high - (Distance)low);
+}
+
+template <class Type>
+size_t SearchingAlgo<Type>::nearestOf(const Type arrListSorted[], size_t num, const Type& item, size_t pos){
+    // The nearest element is the lower bound or the element before it; 0 if the array is empty.
+    if(pos == 0)
+        return 0;
+    if(pos == num)
+        return num - 1;
+    SEARCH_STATS_ADD(probes, 2);
+    SEARCH_STATS_ADD(comparisons, 1);
+    return keyDistance(arrListSorted[pos - 1], item) <= keyDistance(item, arrListSorted[pos]) ? pos - 1 : pos;
+}
+
+template <class Type>
+size_t SearchingAlgo<Type>::nearestSearch(const Type arrListSorted[], size_t num, const Type& item, SearchMethod method){
+    SEARCH_STATS_BEGIN(statsNearest);
+    return nearestOf(arrListSorted, num, item, lowerBound(arrListSorted, num, item, method));
+}
+
+template <class Type>
+RangeView<Type> SearchingAlgo<Type>::kNearestSearch(const Type arrListSorted[], size_t num, const Type& item, size_t k, SearchMethod method){
+    SEARCH_STATS_BEGIN(statsKNearest);
+    if(k >= num)
+        return RangeView<Type>{arrListSorted, arrListSorted + num, 0};
+    size_t pos = lowerBound(arrListSorted, num, item, method);
+    // The k nearest elements surround the lower bound: their window starts between pos - k and pos.
+    // A window starting at element a, with b the first element after it, is beaten by the next
+    // window when b is nearer than a; true for a prefix of the start positions.
+    auto nextIsNearer = [&item, k](const Type& a){
+        const Type& b = (&a)[k];
+        if(!(a < item))
+            return false;
+        if(!(item < b))
+            return true;
+        return keyDistance(item, b) < keyDistance(a, item);
+    };
+    size_t first = binaryPartition(arrListSorted, pos > k ? pos - k : 0, min(pos, num - k), nextIsNearer);
+    return RangeView<Type>{arrListSorted + first, arrListSorted + first + k, first};
+}
+
+template <class Type>
+RangeView<Type> SearchingAlgo<Type>::toleranceSearch(const Type arrListSorted[], size_t num, const Type& item, const Type& tolerance){
+    return rangeQuery(arrListSorted, num, item - tolerance, item + tolerance);
+}
+
+template <class Type>
+bool SearchingAlgo<Type>::approximateSearch(const Type arrListSorted[], size_t num, const Type& item, const Type& tolerance, SearchMethod method){
+    SEARCH_STATS_BEGIN(statsApproximate);
+    size_t pos = nearestSearch(arrListSorted, num, item, method);
+    return pos < num && !SEARCH_STATS_PROBE(arrListSorted[pos] < item - tolerance) && !SEARCH_STATS_COMPARE(item + tolerance < arrListSorted[pos]);
+}
+
+template <class Type>
+void SearchingAlgo<Type>::nearestSearchBatch(const Type arrListSorted[], size_t num, const Type items[], size_t nitems, size_t results[]){
+    SEARCH_STATS_BEGIN(statsNearestBatch);
+    simdLowerBounds(arrListSorted, num, items, nitems, results);
+#ifdef SEARCHINGALGO_INSTRUMENT
+    // Every item takes the same steps (see scalarLowerBounds()), and one more probe at the end.
+    size_t steps = 0;
+    for(size_t length = num; length > 1; length -= length / 2)
+        steps++;
+    SEARCH_STATS_ADD(iterations, nitems * steps);
+    SEARCH_STATS_ADD(probes, num ? nitems * (steps + 1) : 0);
+    SEARCH_STATS_ADD(comparisons, num ? nitems * (steps + 1) : 0);
+#endif
+    for(size_t i = 0; i < nitems; i++)
+        results[i] = nearestOf(arrListSorted, num, items[i], results[i]);
+}
+
+template <class Type>
+size_t SearchingAlgo<Type>::findPosition(const Type arrListSorted[], size_t num, const Type& item, SearchMethod method){
+    SEARCH_STATS_BEGIN(statsFindPosition);
+    size_t pos = lowerBound(arrListSorted, num, item, method);
+    if(pos < num && !SEARCH_STATS_PROBE(item < arrListSorted[pos]))
+        return pos;
+    return num;
+}
+
+template <class Type>
+template <class Predicate>
+size_t SearchingAlgo<Type>::partitionPoint(const Type arrListSorted[], size_t num, const Type& item, Predicate inPrefix, SearchMethod method){
+    switch(method){
+        case searchExponential:
+            return exponentialPartition(arrListSorted, num, inPrefix);
+        case searchFibonacci:
+            return fibonacciPartition(arrListSorted, num, inPrefix);
+        case searchInterpolation:
+            return interpolationPartition(arrListSorted, num, item, inPrefix);
+        case searchJump:
+            return jumpPartition(arrListSorted, num, inPrefix);
+        default:
+            return binaryPartition(arrListSorted, 0, num, inPrefix);
+    }
+}
+
+template <class Type>
+template <class Predicate>
+size_t SearchingAlgo<Type>::binaryPartition(const Type arrListSorted[], size_t first, size_t last, Predicate inPrefix){
+    // The answer is within [first, last]: every element before first is in the prefix,
+    // and every element from last onwards is not.
+    while(first < last){
+        size_t middle = first + (last - first) / 2;
+        SEARCH_STATS_ADD(iterations, 1);
+        if(SEARCH_STATS_PROBE(inPrefix(arrListSorted[middle])))
+            first = middle + 1;
         else
-            return recursiveSublistSearch(largeList, ++startLoc, startLoc, smallList, smallList.begin());
+            last = middle;
+    }
+    return first;
+}
+
+template <class Type>
+template <class Predicate>
+size_t SearchingAlgo<Type>::exponentialPartition(const Type arrListSorted[], size_t num, Predicate inPrefix){
+    if(num == 0 || !SEARCH_STATS_PROBE(inPrefix(arrListSorted[0])))
+        return 0;
+
+    // Double the index until it reaches an element outside the prefix or the end of the array.
+    size_t index = 1;
+    while(index < num && SEARCH_STATS_PROBE(inPrefix(arrListSorted[index]))){
+        SEARCH_STATS_ADD(iterations, 1);
+        index *= 2;
     }
+
+    // Binary search between (index/2 + 1)th and index-th element.
+    return binaryPartition(arrListSorted, index / 2 + 1, min(index, num), inPrefix);
+}
+
+template <class Type>
+template <class Predicate>
+size_t SearchingAlgo<Type>::fibonacciPartition(const Type arrListSorted[], size_t num, Predicate inPrefix){
+    size_t fibN_1 = 1;
+    size_t fibN_2 = 0;
+    size_t fib = fibN_1 + fibN_2;
+
+    // Determine the smallest fibonacci number greater or equal to num.
+    while(fib < num){
+        fibN_2 = fibN_1;
+        fibN_1 = fib;
+        fib = fibN_1 + fibN_2;
+    }
+
+    // Number of leading elements known to be in the prefix.
+    size_t offset = 0;
+
+    while(fib > 1){
+        size_t index = min(offset + fibN_2, num) - 1;
+        SEARCH_STATS_ADD(iterations, 1);
+
+        // One step down fibonacci sequence if the element is in the prefix.
+        if(SEARCH_STATS_PROBE(inPrefix(arrListSorted[index]))){
+            fib = fibN_1;
+            fibN_1 = fibN_2;
+            fibN_2 = fib - fibN_1;
+            offset = index + 1;
+        }
+        // Two steps down otherwise.
+        else{
+            fib = fibN_2;
+            fibN_1 = fibN_1 - fibN_2;
+            fibN_2 = fib - fibN_1;
+        }
+    }
+
+    // There might be one element left to compare.
+    if(fib && offset < num && SEARCH_STATS_PROBE(inPrefix(arrListSorted[offset])))
+        offset++;
+    return offset;
+}
+
+template <class Type>
+template <class Predicate>
+size_t SearchingAlgo<Type>::interpolationPartition(const Type arrListSorted[], size_t num, const Type& item, Predicate inPrefix){
+    size_t first = 0, last = num;
+    int probesLeft = interpolationProbeLimit(num);
+    // Interpolation is only trusted while it keeps shrinking the range quickly.
+    // After a step that fails to halve it, the next probe is a plain binary search step.
+    bool bisect = false;
+
+    while(first < last){
+        size_t oldSize = last - first;
+        size_t pos;
+        if(bisect || probesLeft <= 0)
+            pos = first + oldSize / 2;
+        else{
+            pos = interpolationProbe(arrListSorted, first, last - 1, item, InterpolationKind());
+            probesLeft--;
+        }
+        SEARCH_STATS_ADD(iterations, 1);
+
+        if(SEARCH_STATS_PROBE(inPrefix(arrListSorted[pos])))
+            first = pos + 1;
+        else
+            last = pos;
+        bisect = !bisect && (last - first) > oldSize / 2;
+    }
+    return first;
+}
+
+template <class Type>
+int SearchingAlgo<Type>::interpolationProbeLimit(size_t num){
+    int logN = 0, logLogN = 0;
+    while(num >>= 1)
+        logN++;
+    while(logN >>= 1)
+        logLogN++;
+    return 2 * logLogN + 4;
+}
+
+template <class Type>
+size_t SearchingAlgo<Type>::interpolationProbe(const Type arrListSorted[], size_t first, size_t last, const Type& item, integral_constant<int, 2>){
+    const Type& low = arrListSorted[first];
+    const Type& high = arrListSorted[last];
+    if(!(item > low))
+        return first;
+    if(!(item < high))
+        return last;
+    // low < item < high here. Differences are taken in unsigned 64-bit arithmetic, which is exact
+    // for every integer type up to 64 bits, including signed ones, so the probe does not go through double.
+    unsigned long long span = (unsigned long long)high - (unsigned long long)low;
+    unsigned long long offset = (unsigned long long)item - (unsigned long long)low;
+#ifdef __SIZEOF_INT128__
+    return first + (size_t)((unsigned __int128)offset * (last - first) / span);
+#else
+    return first + (size_t)((long double)offset / span * (last - first));
+#endif
+}
+
+template <class Type>
+size_t SearchingAlgo<Type>::interpolationProbe(const Type arrListSorted[], size_t first, size_t last, const Type& item, integral_constant<int, 1>){
+    const Type& low = arrListSorted[first];
+    const Type& high = arrListSorted[last];
+    if(!(item > low))
+        return first;
+    if(!(item < high))
+        return last;
+    // low < item < high here, so high - low is not zero. The ratio may still be NaN or out of
+    // range when the values are infinite, or round to 1; clamp it to the range.
+    double ratio = ((double)item - (double)low) / ((double)high - (double)low);
+    if(!(ratio > 0))
+        return first;
+    if(!(ratio < 1))
+        return last;
+    return first + (size_t)(ratio * (last - first));
+}
+
+template <class Type>
+size_t SearchingAlgo<Type>::interpolationProbe(const Type[], size_t first, size_t last, const Type&, integral_constant<int, 0>){
+    return first + (last - first) / 2;
+}
+
+template <class Type>
+template <class Predicate>
+size_t SearchingAlgo<Type>::jumpPartition(const Type arrListSorted[], size_t num, Predicate inPrefix){
+    if(num == 0)
+        return 0;
+
+    // The number of steps taken for each jump.
+    size_t step = max((size_t)sqrt((double)num), (size_t)1);
+    size_t prev = 0;
+    size_t jumpLoc = min(step, num);
+
+    // Jump ahead while the last element of the block is in the prefix.
+    while(SEARCH_STATS_PROBE(inPrefix(arrListSorted[jumpLoc - 1]))){
+        if(jumpLoc == num)
+            return num;
+        prev = jumpLoc;
+        jumpLoc = min(jumpLoc + step, num);
+        SEARCH_STATS_ADD(iterations, 1);
+    }
+
+    // Linear search within the block for the first element outside the prefix.
+    while(SEARCH_STATS_PROBE(inPrefix(arrListSorted[prev])))
+        prev++;
+    return prev;
 }
 
 #endif // SEARCHINGALGO.H
@@ -0,0 +1,124 @@
+#ifndef SEQUENCESEARCH_H
+#define SEQUENCESEARCH_H
+
+#include <vector>
+#include <cstddef>
+using namespace std;
+
+// Knuth-Morris-Pratt matcher for a fixed pattern of elements.
+// The pattern is copied into a contiguous buffer and preprocessed once, then any number of
+// sequences can be scanned in a single forward pass over their elements, with no recursion
+// and no backtracking: O(n + m) time and O(m) memory for a pattern of m elements.
+// Sequences are given as iterator pairs (pointers, vector or list iterators...).
+template <class Type>
+class SequenceMatcher {
+    public:
+        // Preprocess the pattern [patternFirst, patternLast).
+        template <class Iterator>
+        SequenceMatcher(Iterator patternFirst, Iterator patternLast);
+
+        size_t patternSize() const { return pattern.size(); }
+
+        // Return the offset of the first occurrence of the pattern in [first, last),
+        // or the length of the sequence if there is none. An empty pattern matches at offset 0.
+        template <class Iterator>
+        size_t findFirst(Iterator first, Iterator last) const;
+
+        // Return the offsets of every occurrence of the pattern in [first, last), in ascending order.
+        // Occurrences may overlap.
+        template <class Iterator>
+        vector<size_t> findAll(Iterator first, Iterator last) const;
+
+        // Return true if the pattern occurs in [first, last).
+        template <class Iterator>
+        bool contains(Iterator first, Iterator last) const;
+
+        // Return the number of pattern elements matched after reading element, when matched
+        // elements were matched before it. A result equal to patternSize() is a full match;
+        // the next call should then pass that value again.
+        size_t advance(size_t matched, const Type& element) const;
+
+    private:
+        vector<Type> pattern;
+        // failure[i]: length of the longest proper prefix of pattern[0..i] that is also its suffix.
+        vector<size_t> failure;
+};
+
+template <class Type>
+template <class Iterator>
+SequenceMatcher<Type>::SequenceMatcher(Iterator patternFirst, Iterator patternLast)
+    : pattern(patternFirst, patternLast), failure(pattern.size(), 0){
+    size_t matched = 0;
+    for(size_t i = 1; i < pattern.size(); i++){
+        while(matched > 0 && !(pattern[i] == pattern[matched]))
+            matched = failure[matched - 1];
+        if(pattern[i] == pattern[matched])
+            matched++;
+        failure[i] = matched;
+    }
+}
+
+template <class Type>
+size_t SequenceMatcher<Type>::advance(size_t matched, const Type& element) const{
+    // After a full match, continue from the longest border of the pattern.
+    if(matched == pattern.size())
+        matched = matched > 0 ? failure[matched - 1] : 0;
+    // Fall back through the borders until element extends one of them.
+    while(matched > 0 && !(element == pattern[matched]))
+        matched = failure[matched - 1];
+    if(matched < pattern.size() && element == pattern[matched])
+        matched++;
+    return matched;
+}
+
+template <class Type>
+template <class Iterator>
+size_t SequenceMatcher<Type>::findFirst(Iterator first, Iterator last) const{
+    if(pattern.empty())
+        return 0;
+    size_t matched = 0, offset = 0;
+    for(; first != last; ++first){
+        matched = advance(matched, *first);
+        offset++;
+        if(matched == pattern.size())
+            return offset - pattern.size();
+    }
+    return offset;
+}
+
+template <class Type>
+template <class Iterator>
+vector<size_t> SequenceMatcher<Type>::findAll(Iterator first, Iterator last) const{
+    vector<size_t> offsets;
+    size_t matched = 0, offset = 0;
+    if(pattern.empty()){
+        // The empty pattern occurs before every element and at the end.
+        for(; first != last; ++first)
+            offsets.push_back(offset++);
+        offsets.push_back(offset);
+        return offsets;
+    }
+    for(; first != last; ++first){
+        matched = advance(matched, *first);
+        offset++;
+        if(matched == pattern.size())
+            offsets.push_back(offset - pattern.size());
+    }
+    return offsets;
+}
+
+template <class Type>
+template <class Iterator>
+bool SequenceMatcher<Type>::contains(Iterator first, Iterator last) const{
+    if(pattern.empty())
+        return true;
+    size_t matched = 0;
+    for(; first != last; ++first){
+        matched = advance(matched, *first);
+        if(matched == pattern.size())
+            return true;
+    }
+    return false;
+}
+
+#endif // SEQUENCESEARCH_H
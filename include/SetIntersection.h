@@ -0,0 +1,153 @@
+#ifndef SETINTERSECTION_H
+#define SETINTERSECTION_H
+
+#include <SearchingAlgo.h>
+#include <SimdSearch.h>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cstddef>
+using namespace std;
+
+// Intersection of sorted arrays, as std::set_intersection computes it (an element repeated in
+// both arrays appears as many times as in the array where it is repeated least), with the
+// algorithm picked from the ratio between the sizes of the arrays:
+// intersectMerge: one pass over both arrays, without branches. O(m + n); best for similar sizes.
+// intersectBlock: the large array is skipped through blocks of intersectBlockSize elements,
+//                 comparing only the last element of each block; the block that may hold a key is
+//                 then scanned with SIMD compares (see simdFind()). O(m + n / intersectBlockSize).
+// intersectGallop: each key of the small array is searched with exponentialSearch from the
+//                 position of the previous one. O(m log(n / m)); best for very different sizes.
+// intersectAuto: intersectMerge below a ratio of intersectBlockRatio, intersectGallop from
+//                intersectGallopRatio, intersectBlock in between.
+// m is the size of the smaller array and n of the larger.
+enum IntersectMethod {
+    intersectAuto,
+    intersectMerge,
+    intersectBlock,
+    intersectGallop
+};
+
+const size_t intersectBlockSize = 16;
+const size_t intersectBlockRatio = 8;
+const size_t intersectGallopRatio = 256;
+
+// Return the name of method, e.g. "gallop" for intersectGallop.
+inline const char* intersectMethodName(IntersectMethod method){
+    switch(method){
+        case intersectAuto: return "auto";
+        case intersectMerge: return "merge";
+        case intersectBlock: return "block";
+        case intersectGallop: return "gallop";
+    }
+    return "unknown";
+}
+
+// Return the method intersectAuto uses for arrays of sizes smallSize <= largeSize.
+inline IntersectMethod chooseIntersectMethod(size_t smallSize, size_t largeSize){
+    if(largeSize < smallSize * intersectBlockRatio)
+        return intersectMerge;
+    if(largeSize < smallSize * intersectGallopRatio)
+        return intersectBlock;
+    return intersectGallop;
+}
+
+// The kernels write the intersection of small (m elements) and large (n elements) to out, and
+// return its size. out needs room for m elements, and may be small itself: an element is only
+// written over once it has been read.
+
+template <class Type>
+size_t mergeIntersect(const Type small[], size_t m, const Type large[], size_t n, Type out[]){
+    size_t i = 0, j = 0, count = 0;
+    while(i < m && j < n){
+        Type x = small[i];
+        Type y = large[j];
+        // Written whatever the outcome, and kept only if both are equal: count <= i and count <= j.
+        out[count] = x;
+        count += !(x < y) && !(y < x);
+        i += !(y < x);
+        j += !(x < y);
+    }
+    return count;
+}
+
+template <class Type>
+size_t blockIntersect(const Type small[], size_t m, const Type large[], size_t n, Type out[]){
+    size_t j = 0, count = 0;
+    for(size_t i = 0; i < m && j < n; i++){
+        Type x = small[i];
+        // Skip the blocks whose last element is less than x.
+        while(j + intersectBlockSize <= n && large[j + intersectBlockSize - 1] < x)
+            j += intersectBlockSize;
+        size_t length = min(intersectBlockSize, n - j);
+        size_t pos = simdFind(large + j, length, x);
+        if(pos < length){
+            out[count++] = x;
+            // The next key may be an equal one, matching the next equal element.
+            j += pos + 1;
+        }
+        // Otherwise the block may still hold the next key, and j stays at its start.
+    }
+    return count;
+}
+
+template <class Type>
+size_t gallopIntersect(const Type small[], size_t m, const Type large[], size_t n, Type out[]){
+    SearchingAlgo<Type> searcher;
+    size_t j = 0, count = 0;
+    for(size_t i = 0; i < m && j < n; i++){
+        Type x = small[i];
+        // Gallop from the previous position: the distance to the next match is usually about n / m.
+        j += searcher.lowerBound(large + j, n - j, x, searchExponential);
+        if(j < n && !(x < large[j])){
+            out[count++] = x;
+            j++;
+        }
+    }
+    return count;
+}
+
+// Write the intersection of a (na elements) and b (nb elements), both sorted ascending, to out
+// and return its size. out needs room for min(na, nb) elements.
+template <class Type>
+size_t intersectSorted(const Type a[], size_t na, const Type b[], size_t nb, Type out[], IntersectMethod method = intersectAuto){
+    const Type* small = a;
+    const Type* large = b;
+    size_t m = na, n = nb;
+    if(n < m){
+        swap(small, large);
+        swap(m, n);
+    }
+    if(method == intersectAuto)
+        method = chooseIntersectMethod(m, n);
+    switch(method){
+        case intersectMerge:
+            return mergeIntersect(small, m, large, n, out);
+        case intersectBlock:
+            return blockIntersect(small, m, large, n, out);
+        default:
+            return gallopIntersect(small, m, large, n, out);
+    }
+}
+
+// Return the intersection of the k-way lists given as (array, size) pairs, each sorted ascending.
+// The lists are intersected from the smallest up, so that each step intersects the running result,
+// which only shrinks, with a larger list, and stops as soon as the result is empty. Each step picks
+// its algorithm from the size ratio, as intersectAuto does.
+template <class Type>
+vector<Type> intersectSorted(vector<pair<const Type*, size_t> > lists){
+    if(lists.empty())
+        return vector<Type>();
+    sort(lists.begin(), lists.end(),
+         [](const pair<const Type*, size_t>& x, const pair<const Type*, size_t>& y){ return x.second < y.second; });
+
+    vector<Type> result(lists[0].first, lists[0].first + lists[0].second);
+    for(size_t l = 1; l < lists.size() && !result.empty(); l++){
+        // The result is the smaller array, so it can be written in place.
+        size_t count = intersectSorted(result.data(), result.size(), lists[l].first, lists[l].second, result.data());
+        result.resize(count);
+    }
+    return result;
+}
+
+#endif // SETINTERSECTION_H
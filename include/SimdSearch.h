@@ -0,0 +1,487 @@
+#ifndef SIMDSEARCH_H
+#define SIMDSEARCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+using namespace std;
+
+// Vectorized kernels used by the linear scans of SearchingAlgo.
+// simdFind() returns the index of the first element equal to item, or num if there is none.
+// 32 and 64-bit integers, float and double are compared several elements per instruction
+// with SSE2, AVX2 or AVX-512, picked at runtime from the features of the CPU.
+// simdLowerBounds() binary searches many keys side by side, one key per vector lane; float and
+// double keys use AVX2 gathers.
+// Every other Type, and every other compiler or processor, uses the plain loop.
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define SEARCHINGALGO_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+// Plain loop, used for generic Type and for the elements left over after the vector loop.
+template <class Type>
+size_t scalarFind(const Type arr[], size_t first, size_t num, const Type& item){
+    for(size_t i = first; i < num; i++){
+        if(arr[i] == item)
+            return i;
+    }
+    return num;
+}
+
+// Plain loop: results[k] receives the index of the first element of arr not less than keys[k],
+// for k from first to nkeys - 1. Walks the same steps as the vector kernels.
+template <class Type>
+void scalarLowerBounds(const Type arr[], size_t num, const Type keys[], size_t first, size_t nkeys, size_t results[]){
+    for(size_t k = first; k < nkeys; k++){
+        size_t base = 0, length = num;
+        while(length > 1){
+            size_t half = length / 2;
+            base = arr[base + half] < keys[k] ? base + half : base;
+            length -= half;
+        }
+        results[k] = num ? base + (arr[base] < keys[k]) : 0;
+    }
+}
+
+#ifdef SEARCHINGALGO_X86_SIMD
+
+// Instruction set levels available for the kernels.
+enum SimdLevel { simdSSE2, simdAVX2, simdAVX512 };
+
+// Detect the best instruction set supported by the CPU. Only done once.
+inline SimdLevel detectSimdLevel(){
+    static const SimdLevel level = [](){
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx512f"))
+            return simdAVX512;
+        if(__builtin_cpu_supports("avx2"))
+            return simdAVX2;
+        return simdSSE2;
+    }();
+    return level;
+}
+
+// Each kernel compares 4 vectors per iteration and returns the index of the first match, then
+// one vector at a time, so that arrays shorter than 4 vectors are compared in vectors as well;
+// only the last elements that do not fill a vector go through the plain loop.
+// The 32-bit kernels handle int32 and float, the 64-bit ones handle int64 and double.
+
+__attribute__((target("sse2")))
+inline size_t findInt32SSE2(const int32_t arr[], size_t num, int32_t item){
+    const __m128i key = _mm_set1_epi32(item);
+    size_t i = 0;
+    for(; i + 16 <= num; i += 16){
+        __m128i a = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(arr + i)), key);
+        __m128i b = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(arr + i + 4)), key);
+        __m128i c = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(arr + i + 8)), key);
+        __m128i d = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(arr + i + 12)), key);
+        // Saturating packs narrow each 32-bit result to one byte, so there is one mask bit per element.
+        unsigned mask = _mm_movemask_epi8(_mm_packs_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+        if(mask)
+            return i + __builtin_ctz(mask);
+    }
+    for(; i + 4 <= num; i += 4){
+        unsigned mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(arr + i)), key)));
+        if(mask)
+            return i + __builtin_ctz(mask);
+    }
+    return scalarFind(arr, i, num, item);
+}
+
+__attribute__((target("sse2")))
+inline size_t findFloatSSE2(const float arr[], size_t num, float item){
+    const __m128 key = _mm_set1_ps(item);
+    size_t i = 0;
+    for(; i + 16 <= num; i += 16){
+        unsigned mask = _mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(arr + i), key))
+                      | _mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(arr + i + 4), key)) << 4
+                      | _mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(arr + i + 8), key)) << 8
+                      | _mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(arr + i + 12), key)) << 12;
+        if(mask)
+            return i + __builtin_ctz(mask);
+    }
+    for(; i + 4 <= num; i += 4){
+        unsigned mask = _mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(arr + i), key));
+        if(mask)
+            return i + __builtin_ctz(mask);
+    }
+    return scalarFind(arr, i, num, item);
+}
+
+__attribute__((target("sse2")))
+inline size_t findInt64SSE2(const int64_t arr[], size_t num, int64_t item){
+    // SSE2 has no 64-bit equality, so both 32-bit halves must be equal.
+    const __m128i key = _mm_set1_epi64x(item);
+    size_t i = 0;
+    for(; i + 8 <= num; i += 8){
+        unsigned mask = 0;
+        for(size_t j = 0; j < 4; j++){
+            __m128i eq = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(arr + i + 2 * j)), key);
+            eq = _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+            mask |= (unsigned)_mm_movemask_pd(_mm_castsi128_pd(eq)) << (2 * j);
+        }
+        if(mask)
+            return i + __builtin_ctz(mask);
+    }
+    for(; i + 2 <= num; i += 2){
+        __m128i eq = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(arr + i)), key);
+        eq = _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+        unsigned mask = _mm_movemask_pd(_mm_castsi128_pd(eq));
+        if(mask)
+            return i + __builtin_ctz(mask);
+    }
+    return scalarFind(arr, i, num, item);
+}
+
+__attribute__((target("sse2")))
+inline size_t findDoubleSSE2(const double arr[], size_t num, double item){
+    const __m128d key = _mm_set1_pd(item);
+    size_t i = 0;
+    for(; i + 8 <= num; i += 8){
+        unsigned mask = _mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(arr + i), key))
+                      | _mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(arr + i + 2), key)) << 2
+                      | _mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(arr + i + 4), key)) << 4
+                      | _mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(arr + i + 6), key)) << 6;
+        if(mask)
+            return i + __builtin_ctz(mask);
+    }
+    for(; i + 2 <= num; i += 2){
+        unsigned mask = _mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(arr + i), key));
+        if(mask)
+            return i + __builtin_ctz(mask);
+    }
+    return scalarFind(arr, i, num, item);
+}
+
+__attribute__((target("avx2")))
+inline size_t findInt32AVX2(const int32_t arr[], size_t num, int32_t item){
+    const __m256i key = _mm256_set1_epi32(item);
+    size_t i = 0;
+    for(; i + 32 <= num; i += 32){
+        __m256i a = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(arr + i)), key);
+        __m256i b = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(arr + i + 8)), key);
+        __m256i c = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(arr + i + 16)), key);
+        __m256i d = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(arr + i + 24)), key);
+        __m256i any = _mm256_or_si256(_mm256_or_si256(a, b), _mm256_or_si256(c, d));
+        if(!_mm256_testz_si256(any, any)){
+            unsigned long long mask = (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(a))
+                                    | (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(b)) << 8
+                                    | (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(c)) << 16
+                                    | (unsigned long long)_mm256_movemask_ps(_mm256_castsi256_ps(d)) << 24;
+            return i + __builtin_ctzll(mask);
+        }
+    }
+    for(; i + 8 <= num; i += 8){
+        unsigned mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(arr + i)), key)));
+        if(mask)
+            return i + __builtin_ctz(mask);
+    }
+    return findInt32SSE2(arr + i, num - i, item) + i;
+}
+
+__attribute__((target("avx2")))
+inline size_t findFloatAVX2(const float arr[], size_t num, float item){
+    const __m256 key = _mm256_set1_ps(item);
+    size_t i = 0;
+    for(; i + 32 <= num; i += 32){
+        unsigned long long mask = (unsigned)_mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(arr + i), key, _CMP_EQ_OQ))
+                                | (unsigned)_mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(arr + i + 8), key, _CMP_EQ_OQ)) << 8
+                                | (unsigned)_mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(arr + i + 16), key, _CMP_EQ_OQ)) << 16
+                                | (unsigned long long)_mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(arr + i + 24), key, _CMP_EQ_OQ)) << 24;
+        if(mask)
+            return i + __builtin_ctzll(mask);
+    }
+    for(; i + 8 <= num; i += 8){
+        unsigned mask = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(arr + i), key, _CMP_EQ_OQ));
+        if(mask)
+            return i + __builtin_ctz(mask);
+    }
+    return findFloatSSE2(arr + i, num - i, item) + i;
+}
+
+__attribute__((target("avx2")))
+inline size_t findInt64AVX2(const int64_t arr[], size_t num, int64_t item){
+    const __m256i key = _mm256_set1_epi64x(item);
+    size_t i = 0;
+    for(; i + 16 <= num; i += 16){
+        unsigned mask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*)(arr + i)), key)))
+                      | _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*)(arr + i + 4)), key))) << 4
+                      | _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*)(arr + i + 8)), key))) << 8
+                      | _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*)(arr + i + 12)), key))) << 12;
+        if(mask)
+            return i + __builtin_ctz(mask);
+    }
+    for(; i + 4 <= num; i += 4){
+        unsigned mask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*)(arr + i)), key)));
+        if(mask)
+            return i + __builtin_ctz(mask);
+    }
+    return findInt64SSE2(arr + i, num - i, item) + i;
+}
+
+__attribute__((target("avx2")))
+inline size_t findDoubleAVX2(const double arr[], size_t num, double item){
+    const __m256d key = _mm256_set1_pd(item);
+    size_t i = 0;
+    for(; i + 16 <= num; i += 16){
+        unsigned mask = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(arr + i), key, _CMP_EQ_OQ))
+                      | _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(arr + i + 4), key, _CMP_EQ_OQ)) << 4
+                      | _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(arr + i + 8), key, _CMP_EQ_OQ)) << 8
+                      | _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(arr + i + 12), key, _CMP_EQ_OQ)) << 12;
+        if(mask)
+            return i + __builtin_ctz(mask);
+    }
+    for(; i + 4 <= num; i += 4){
+        unsigned mask = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(arr + i), key, _CMP_EQ_OQ));
+        if(mask)
+            return i + __builtin_ctz(mask);
+    }
+    return findDoubleSSE2(arr + i, num - i, item) + i;
+}
+
+__attribute__((target("avx512f")))
+inline size_t findInt32AVX512(const int32_t arr[], size_t num, int32_t item){
+    const __m512i key = _mm512_set1_epi32(item);
+    size_t i = 0;
+    for(; i + 32 <= num; i += 32){
+        unsigned mask = _mm512_cmpeq_epi32_mask(_mm512_loadu_si512(arr + i), key)
+                      | (unsigned)_mm512_cmpeq_epi32_mask(_mm512_loadu_si512(arr + i + 16), key) << 16;
+        if(mask)
+            return i + __builtin_ctz(mask);
+    }
+    // Remaining elements are compared under a mask, without reading past the end.
+    for(; i < num; i += 16){
+        __mmask16 valid = num - i >= 16 ? 0xFFFF : (__mmask16)((1u << (num - i)) - 1);
+        unsigned mask = _mm512_mask_cmpeq_epi32_mask(valid, _mm512_maskz_loadu_epi32(valid, arr + i), key);
+        if(mask)
+            return i + __builtin_ctz(mask);
+    }
+    return num;
+}
+
+__attribute__((target("avx512f")))
+inline size_t findFloatAVX512(const float arr[], size_t num, float item){
+    const __m512 key = _mm512_set1_ps(item);
+    size_t i = 0;
+    for(; i + 32 <= num; i += 32){
+        unsigned mask = _mm512_cmp_ps_mask(_mm512_loadu_ps(arr + i), key, _CMP_EQ_OQ)
+                      | (unsigned)_mm512_cmp_ps_mask(_mm512_loadu_ps(arr + i + 16), key, _CMP_EQ_OQ) << 16;
+        if(mask)
+            return i + __builtin_ctz(mask);
+    }
+    for(; i < num; i += 16){
+        __mmask16 valid = num - i >= 16 ? 0xFFFF : (__mmask16)((1u << (num - i)) - 1);
+        unsigned mask = _mm512_mask_cmp_ps_mask(valid, _mm512_maskz_loadu_ps(valid, arr + i), key, _CMP_EQ_OQ);
+        if(mask)
+            return i + __builtin_ctz(mask);
+    }
+    return num;
+}
+
+__attribute__((target("avx512f")))
+inline size_t findInt64AVX512(const int64_t arr[], size_t num, int64_t item){
+    const __m512i key = _mm512_set1_epi64(item);
+    size_t i = 0;
+    for(; i + 16 <= num; i += 16){
+        unsigned mask = _mm512_cmpeq_epi64_mask(_mm512_loadu_si512(arr + i), key)
+                      | (unsigned)_mm512_cmpeq_epi64_mask(_mm512_loadu_si512(arr + i + 8), key) << 8;
+        if(mask)
+            return i + __builtin_ctz(mask);
+    }
+    for(; i < num; i += 8){
+        __mmask8 valid = num - i >= 8 ? 0xFF : (__mmask8)((1u << (num - i)) - 1);
+        unsigned mask = _mm512_mask_cmpeq_epi64_mask(valid, _mm512_maskz_loadu_epi64(valid, arr + i), key);
+        if(mask)
+            return i + __builtin_ctz(mask);
+    }
+    return num;
+}
+
+__attribute__((target("avx512f")))
+inline size_t findDoubleAVX512(const double arr[], size_t num, double item){
+    const __m512d key = _mm512_set1_pd(item);
+    size_t i = 0;
+    for(; i + 16 <= num; i += 16){
+        unsigned mask = _mm512_cmp_pd_mask(_mm512_loadu_pd(arr + i), key, _CMP_EQ_OQ)
+                      | (unsigned)_mm512_cmp_pd_mask(_mm512_loadu_pd(arr + i + 8), key, _CMP_EQ_OQ) << 8;
+        if(mask)
+            return i + __builtin_ctz(mask);
+    }
+    for(; i < num; i += 8){
+        __mmask8 valid = num - i >= 8 ? 0xFF : (__mmask8)((1u << (num - i)) - 1);
+        unsigned mask = _mm512_mask_cmp_pd_mask(valid, _mm512_maskz_loadu_pd(valid, arr + i), key, _CMP_EQ_OQ);
+        if(mask)
+            return i + __builtin_ctz(mask);
+    }
+    return num;
+}
+
+// Branchless binary searches of 16 keys at a time, in 4 vectors walked together: every lane
+// probes the same offset from its own base, read with a gather, so the cache misses of the 16
+// keys overlap. The keys left over go through scalarLowerBounds(). num must not be 0.
+
+__attribute__((target("avx2")))
+inline void lowerBoundsDoubleAVX2(const double arr[], size_t num, const double keys[], size_t nkeys, size_t results[]){
+    size_t k = 0;
+    for(; k + 16 <= nkeys; k += 16){
+        __m256d key[4];
+        __m256i base[4];
+        for(int v = 0; v < 4; v++){
+            key[v] = _mm256_loadu_pd(keys + k + 4 * v);
+            base[v] = _mm256_setzero_si256();
+        }
+        for(size_t length = num; length > 1; ){
+            size_t half = length / 2;
+            const __m256i step = _mm256_set1_epi64x((long long)half);
+            for(int v = 0; v < 4; v++){
+                __m256d probe = _mm256_i64gather_pd(arr + half, base[v], 8);
+                // All ones in the lanes whose probe is less than the key, which move on by half.
+                __m256i less = _mm256_castpd_si256(_mm256_cmp_pd(probe, key[v], _CMP_LT_OQ));
+                base[v] = _mm256_add_epi64(base[v], _mm256_and_si256(less, step));
+            }
+            length -= half;
+        }
+        int64_t positions[16];
+        for(int v = 0; v < 4; v++){
+            __m256i less = _mm256_castpd_si256(_mm256_cmp_pd(_mm256_i64gather_pd(arr, base[v], 8), key[v], _CMP_LT_OQ));
+            _mm256_storeu_si256((__m256i*)(positions + 4 * v), _mm256_sub_epi64(base[v], less));
+        }
+        for(int i = 0; i < 16; i++)
+            results[k + i] = (size_t)positions[i];
+    }
+    scalarLowerBounds(arr, num, keys, k, nkeys, results);
+}
+
+// 32-bit indices: num must be below 2^31.
+__attribute__((target("avx2")))
+inline void lowerBoundsFloatAVX2(const float arr[], size_t num, const float keys[], size_t nkeys, size_t results[]){
+    size_t k = 0;
+    for(; k + 16 <= nkeys; k += 16){
+        __m256 key[2];
+        __m256i base[2];
+        for(int v = 0; v < 2; v++){
+            key[v] = _mm256_loadu_ps(keys + k + 8 * v);
+            base[v] = _mm256_setzero_si256();
+        }
+        for(size_t length = num; length > 1; ){
+            size_t half = length / 2;
+            const __m256i step = _mm256_set1_epi32((int)half);
+            for(int v = 0; v < 2; v++){
+                __m256 probe = _mm256_i32gather_ps(arr + half, base[v], 4);
+                __m256i less = _mm256_castps_si256(_mm256_cmp_ps(probe, key[v], _CMP_LT_OQ));
+                base[v] = _mm256_add_epi32(base[v], _mm256_and_si256(less, step));
+            }
+            length -= half;
+        }
+        int32_t positions[16];
+        for(int v = 0; v < 2; v++){
+            __m256i less = _mm256_castps_si256(_mm256_cmp_ps(_mm256_i32gather_ps(arr, base[v], 4), key[v], _CMP_LT_OQ));
+            _mm256_storeu_si256((__m256i*)(positions + 8 * v), _mm256_sub_epi32(base[v], less));
+        }
+        for(int i = 0; i < 16; i++)
+            results[k + i] = (size_t)positions[i];
+    }
+    scalarLowerBounds(arr, num, keys, k, nkeys, results);
+}
+
+// Kinds of element handled by the kernels.
+enum SimdKind { simdNone, simdInt32, simdInt64, simdFloat, simdDouble };
+
+template <class Type>
+struct SimdKindOf {
+    static const SimdKind value =
+        is_same<Type, float>::value ? simdFloat :
+        is_same<Type, double>::value ? simdDouble :
+        (is_integral<Type>::value && !is_same<Type, bool>::value && sizeof(Type) == 4) ? simdInt32 :
+        (is_integral<Type>::value && !is_same<Type, bool>::value && sizeof(Type) == 8) ? simdInt64 :
+        simdNone;
+};
+
+template <class Type>
+size_t simdFind(const Type arr[], size_t num, const Type& item, integral_constant<SimdKind, simdNone>){
+    return scalarFind(arr, 0, num, item);
+}
+
+// Only equality is tested, so signed and unsigned integers of the same size share a kernel.
+template <class Type>
+size_t simdFind(const Type arr[], size_t num, const Type& item, integral_constant<SimdKind, simdInt32>){
+    const int32_t* a = reinterpret_cast<const int32_t*>(arr);
+    int32_t key = (int32_t)item;
+    switch(detectSimdLevel()){
+        case simdAVX512: return findInt32AVX512(a, num, key);
+        case simdAVX2: return findInt32AVX2(a, num, key);
+        default: return findInt32SSE2(a, num, key);
+    }
+}
+
+template <class Type>
+size_t simdFind(const Type arr[], size_t num, const Type& item, integral_constant<SimdKind, simdInt64>){
+    const int64_t* a = reinterpret_cast<const int64_t*>(arr);
+    int64_t key = (int64_t)item;
+    switch(detectSimdLevel()){
+        case simdAVX512: return findInt64AVX512(a, num, key);
+        case simdAVX2: return findInt64AVX2(a, num, key);
+        default: return findInt64SSE2(a, num, key);
+    }
+}
+
+inline size_t simdFind(const float arr[], size_t num, const float& item, integral_constant<SimdKind, simdFloat>){
+    switch(detectSimdLevel()){
+        case simdAVX512: return findFloatAVX512(arr, num, item);
+        case simdAVX2: return findFloatAVX2(arr, num, item);
+        default: return findFloatSSE2(arr, num, item);
+    }
+}
+
+inline size_t simdFind(const double arr[], size_t num, const double& item, integral_constant<SimdKind, simdDouble>){
+    switch(detectSimdLevel()){
+        case simdAVX512: return findDoubleAVX512(arr, num, item);
+        case simdAVX2: return findDoubleAVX2(arr, num, item);
+        default: return findDoubleSSE2(arr, num, item);
+    }
+}
+
+template <class Type, SimdKind Kind>
+void simdLowerBounds(const Type arr[], size_t num, const Type keys[], size_t nkeys, size_t results[], integral_constant<SimdKind, Kind>){
+    scalarLowerBounds(arr, num, keys, 0, nkeys, results);
+}
+
+inline void simdLowerBounds(const float arr[], size_t num, const float keys[], size_t nkeys, size_t results[], integral_constant<SimdKind, simdFloat>){
+    if(num > 0 && num < ((size_t)1 << 31) && detectSimdLevel() != simdSSE2)
+        lowerBoundsFloatAVX2(arr, num, keys, nkeys, results);
+    else
+        scalarLowerBounds(arr, num, keys, 0, nkeys, results);
+}
+
+inline void simdLowerBounds(const double arr[], size_t num, const double keys[], size_t nkeys, size_t results[], integral_constant<SimdKind, simdDouble>){
+    if(num > 0 && detectSimdLevel() != simdSSE2)
+        lowerBoundsDoubleAVX2(arr, num, keys, nkeys, results);
+    else
+        scalarLowerBounds(arr, num, keys, 0, nkeys, results);
+}
+
+#endif // SEARCHINGALGO_X86_SIMD
+
+// For each of the nkeys keys, results[k] receives the index of the first element of arr (num
+// elements, sorted ascending) not less than keys[k], or num if there is none.
+template <class Type>
+void simdLowerBounds(const Type arr[], size_t num, const Type keys[], size_t nkeys, size_t results[]){
+#ifdef SEARCHINGALGO_X86_SIMD
+    simdLowerBounds(arr, num, keys, nkeys, results, integral_constant<SimdKind, SimdKindOf<Type>::value>());
+#else
+    scalarLowerBounds(arr, num, keys, 0, nkeys, results);
+#endif
+}
+
+// Return the index of the first element of arr equal to item, or num if there is none.
+template <class Type>
+size_t simdFind(const Type arr[], size_t num, const Type& item){
+#ifdef SEARCHINGALGO_X86_SIMD
+    return simdFind(arr, num, item, integral_constant<SimdKind, SimdKindOf<Type>::value>());
+#else
+    return scalarFind(arr, 0, num, item);
+#endif
+}
+
+#endif // SIMDSEARCH_H
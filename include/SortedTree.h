@@ -0,0 +1,560 @@
+#ifndef SORTEDTREE_H
+#define SORTEDTREE_H
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+using namespace std;
+
+// Sorted multiset that stays searchable while it is updated: a B+-tree.
+// Elements are kept in leaves of about 1 KB, sorted and linked in order; inner nodes of up to
+// 64 children hold the separating keys. A search walks log64(n / leaf size) inner nodes, each
+// one or two cache lines of keys, then one leaf, so it stays close to binarySearch on a flat
+// array, while an insert or erase moves at most one leaf of elements instead of the whole array.
+// Type must be default constructible and copyable, and compared with operator<.
+template <class Type>
+class SortedTree {
+    public:
+        // Elements per leaf and children per inner node.
+        static const size_t leafCapacity = 1024 / sizeof(Type) > 16 ? 1024 / sizeof(Type) : 16;
+        static const size_t innerCapacity = 64;
+
+        SortedTree();
+        ~SortedTree();
+
+        // Replace the contents with arrListSorted (num elements, sorted ascending).
+        // Nodes are filled to 3/4 so that the next inserts rarely split them.
+        // Time complexity: O(n)
+        void bulkLoad(const Type arrListSorted[], size_t num);
+
+        // Add item. Equal elements are kept.
+        // Time complexity: O(log n + leafCapacity)
+        void insert(const Type& item);
+
+        // Remove one element equal to item. Return false if there is none.
+        // Time complexity: O(log n + leafCapacity)
+        bool erase(const Type& item);
+
+        // Insert the numInserts elements of inserts, then erase the numErases elements of erases.
+        // Large batches (more than 1/8 of the size) are sorted and merged with the contents
+        // in one pass, then bulk loaded; small ones are applied one by one, in sorted order.
+        // Time complexity: O(k log n) for k small updates, O(n + k log k) for large ones.
+        void applyBatch(const Type inserts[], size_t numInserts, const Type erases[], size_t numErases);
+
+        // Return true if item is in the tree.
+        // Time complexity: O(log n)
+        bool search(const Type& item) const;
+
+        size_t size() const { return num; }
+        bool empty() const { return num == 0; }
+        // Number of inner levels above the leaves.
+        size_t height() const { return levels; }
+        void clear();
+
+        // Call visit(element) for every element in ascending order.
+        template <class Visitor>
+        void forEach(Visitor visit) const;
+
+        // Return the elements in ascending order.
+        vector<Type> toVector() const;
+
+        // Return true if the structure is consistent: elements sorted within and across leaves,
+        // each subtree within the bounds of its separators, all leaves at the same depth,
+        // every node but the root filled to its minimum, the leaf chain in tree order and
+        // the element count equal to size().
+        // Time complexity: O(n)
+        bool validate() const;
+
+    private:
+        SortedTree(const SortedTree&);
+        SortedTree& operator=(const SortedTree&);
+
+        struct Leaf {
+            size_t count;
+            Leaf* next;
+            Type keys[leafCapacity];
+        };
+
+        // keys[i] separates the subtrees: children[i] <= keys[i] <= children[i + 1].
+        struct Inner {
+            size_t count;
+            Type keys[innerCapacity - 1];
+            void* children[innerCapacity];
+        };
+
+        // Node of a search path, and the index of the child taken from it.
+        struct PathEntry {
+            Inner* node;
+            size_t child;
+        };
+
+        // Nodes below these sizes are refilled from a sibling after an erase.
+        static const size_t leafMinimum = leafCapacity / 4;
+        static const size_t innerMinimum = innerCapacity / 4;
+
+        // Index of the child of node to search for item: the number of keys less than item.
+        static size_t childIndex(const Inner* node, const Type& item);
+
+        // Index of the first key of leaf not less than item.
+        static size_t leafLowerBound(const Leaf* leaf, const Type& item);
+
+        // Split the full child i of parent, whose level is childLevel (0 for leaves).
+        void splitChild(Inner* parent, size_t i, size_t childLevel);
+
+        // Refill or merge the child path[depth].child of path[depth].node, which fell below its
+        // minimum, and go up the path while the parent falls below its own.
+        void rebalance(vector<PathEntry>& path, size_t depth);
+
+        // Fill the leaf levels and inner levels from sorted elements.
+        void build(const vector<Type>& sorted);
+
+        void destroy(void* node, size_t level);
+
+        // validate() for the subtree of node, whose level is level (0 for a leaf), and whose
+        // elements must lie between lower and upper (no bound if null).
+        // Its leaves are appended to leaves in order.
+        bool validateNode(const void* node, size_t level, const Type* lower, const Type* upper, vector<const Leaf*>& leaves) const;
+
+        // Leftmost leaf below node.
+        Leaf* firstLeaf() const;
+
+        void* root;
+        // Number of inner levels: root is a Leaf if 0.
+        size_t levels;
+        size_t num;
+};
+
+template <class Type>
+const size_t SortedTree<Type>::leafCapacity;
+
+template <class Type>
+const size_t SortedTree<Type>::innerCapacity;
+
+template <class Type>
+const size_t SortedTree<Type>::leafMinimum;
+
+template <class Type>
+const size_t SortedTree<Type>::innerMinimum;
+
+template <class Type>
+SortedTree<Type>::SortedTree() : levels(0), num(0){
+    Leaf* leaf = new Leaf;
+    leaf->count = 0;
+    leaf->next = 0;
+    root = leaf;
+}
+
+template <class Type>
+SortedTree<Type>::~SortedTree(){
+    destroy(root, levels);
+}
+
+template <class Type>
+void SortedTree<Type>::destroy(void* node, size_t level){
+    if(level == 0){
+        delete (Leaf*)node;
+        return;
+    }
+    Inner* inner = (Inner*)node;
+    for(size_t i = 0; i < inner->count; i++)
+        destroy(inner->children[i], level - 1);
+    delete inner;
+}
+
+template <class Type>
+void SortedTree<Type>::clear(){
+    destroy(root, levels);
+    Leaf* leaf = new Leaf;
+    leaf->count = 0;
+    leaf->next = 0;
+    root = leaf;
+    levels = 0;
+    num = 0;
+}
+
+template <class Type>
+size_t SortedTree<Type>::childIndex(const Inner* node, const Type& item){
+    size_t first = 0, last = node->count - 1;
+    while(first < last){
+        size_t middle = first + (last - first) / 2;
+        if(node->keys[middle] < item)
+            first = middle + 1;
+        else
+            last = middle;
+    }
+    return first;
+}
+
+template <class Type>
+size_t SortedTree<Type>::leafLowerBound(const Leaf* leaf, const Type& item){
+    return lower_bound(leaf->keys, leaf->keys + leaf->count, item) - leaf->keys;
+}
+
+template <class Type>
+typename SortedTree<Type>::Leaf* SortedTree<Type>::firstLeaf() const{
+    void* node = root;
+    for(size_t level = levels; level > 0; level--)
+        node = ((Inner*)node)->children[0];
+    return (Leaf*)node;
+}
+
+template <class Type>
+bool SortedTree<Type>::search(const Type& item) const{
+    void* node = root;
+    for(size_t level = levels; level > 0; level--){
+        const Inner* inner = (const Inner*)node;
+        node = inner->children[childIndex(inner, item)];
+    }
+    const Leaf* leaf = (const Leaf*)node;
+    size_t pos = leafLowerBound(leaf, item);
+    // Elements equal to a separator may start in the next leaf.
+    if(pos == leaf->count){
+        leaf = leaf->next;
+        pos = 0;
+    }
+    return leaf && pos < leaf->count && !(item < leaf->keys[pos]);
+}
+
+template <class Type>
+void SortedTree<Type>::splitChild(Inner* parent, size_t i, size_t childLevel){
+    Type separator;
+    void* right;
+    if(childLevel == 0){
+        Leaf* leaf = (Leaf*)parent->children[i];
+        Leaf* sibling = new Leaf;
+        size_t half = leaf->count / 2;
+        sibling->count = leaf->count - half;
+        copy(leaf->keys + half, leaf->keys + leaf->count, sibling->keys);
+        leaf->count = half;
+        sibling->next = leaf->next;
+        leaf->next = sibling;
+        separator = sibling->keys[0];
+        right = sibling;
+    }
+    else{
+        Inner* inner = (Inner*)parent->children[i];
+        Inner* sibling = new Inner;
+        size_t half = inner->count / 2;
+        sibling->count = inner->count - half;
+        copy(inner->children + half, inner->children + inner->count, sibling->children);
+        copy(inner->keys + half, inner->keys + inner->count - 1, sibling->keys);
+        separator = inner->keys[half - 1];
+        inner->count = half;
+        right = sibling;
+    }
+    copy_backward(parent->keys + i, parent->keys + parent->count - 1, parent->keys + parent->count);
+    copy_backward(parent->children + i + 1, parent->children + parent->count, parent->children + parent->count + 1);
+    parent->keys[i] = separator;
+    parent->children[i + 1] = right;
+    parent->count++;
+}
+
+template <class Type>
+void SortedTree<Type>::insert(const Type& item){
+    // Split full nodes on the way down, so that there is always room for a separator above.
+    bool rootFull = levels == 0 ? ((Leaf*)root)->count == leafCapacity : ((Inner*)root)->count == innerCapacity;
+    if(rootFull){
+        Inner* newRoot = new Inner;
+        newRoot->count = 1;
+        newRoot->children[0] = root;
+        splitChild(newRoot, 0, levels);
+        root = newRoot;
+        levels++;
+    }
+
+    void* node = root;
+    for(size_t level = levels; level > 0; level--){
+        Inner* inner = (Inner*)node;
+        size_t i = childIndex(inner, item);
+        void* child = inner->children[i];
+        bool childFull = level == 1 ? ((Leaf*)child)->count == leafCapacity : ((Inner*)child)->count == innerCapacity;
+        if(childFull){
+            splitChild(inner, i, level - 1);
+            if(inner->keys[i] < item)
+                i++;
+        }
+        node = inner->children[i];
+    }
+
+    Leaf* leaf = (Leaf*)node;
+    size_t pos = leafLowerBound(leaf, item);
+    copy_backward(leaf->keys + pos, leaf->keys + leaf->count, leaf->keys + leaf->count + 1);
+    leaf->keys[pos] = item;
+    leaf->count++;
+    num++;
+}
+
+template <class Type>
+bool SortedTree<Type>::erase(const Type& item){
+    vector<PathEntry> path;
+    void* node = root;
+    for(size_t level = levels; level > 0; level--){
+        Inner* inner = (Inner*)node;
+        PathEntry entry = { inner, childIndex(inner, item) };
+        path.push_back(entry);
+        node = inner->children[entry.child];
+    }
+
+    Leaf* leaf = (Leaf*)node;
+    size_t pos = leafLowerBound(leaf, item);
+    if(pos == leaf->count && leaf->next){
+        // The element may start the next leaf: move the path to it, one child to the right
+        // at the deepest level where that is possible, then down the leftmost children.
+        size_t depth = path.size();
+        while(depth > 0 && path[depth - 1].child + 1 == path[depth - 1].node->count)
+            depth--;
+        if(depth == 0)
+            return false;
+        path[depth - 1].child++;
+        node = path[depth - 1].node->children[path[depth - 1].child];
+        for(; depth < path.size(); depth++){
+            path[depth].node = (Inner*)node;
+            path[depth].child = 0;
+            node = path[depth].node->children[0];
+        }
+        leaf = (Leaf*)node;
+        pos = 0;
+    }
+    if(pos == leaf->count || item < leaf->keys[pos])
+        return false;
+
+    copy(leaf->keys + pos + 1, leaf->keys + leaf->count, leaf->keys + pos);
+    leaf->count--;
+    num--;
+    if(leaf->count < leafMinimum && !path.empty())
+        rebalance(path, path.size() - 1);
+    return true;
+}
+
+template <class Type>
+void SortedTree<Type>::rebalance(vector<PathEntry>& path, size_t depth){
+    Inner* parent = path[depth].node;
+    size_t i = path[depth].child;
+    // Pair the child with its left sibling, or its right one if it is the first child.
+    size_t s = i > 0 ? i - 1 : i;
+    bool leaves = depth + 1 == path.size();
+
+    if(leaves){
+        Leaf* left = (Leaf*)parent->children[s];
+        Leaf* right = (Leaf*)parent->children[s + 1];
+        size_t total = left->count + right->count;
+        if(total <= leafCapacity){
+            copy(right->keys, right->keys + right->count, left->keys + left->count);
+            left->count = total;
+            left->next = right->next;
+            delete right;
+        }
+        else{
+            // Move elements so that both leaves have half of them.
+            size_t half = total / 2;
+            if(left->count < half){
+                size_t moved = half - left->count;
+                copy(right->keys, right->keys + moved, left->keys + left->count);
+                copy(right->keys + moved, right->keys + right->count, right->keys);
+                right->count -= moved;
+            }
+            else{
+                size_t moved = left->count - half;
+                copy_backward(right->keys, right->keys + right->count, right->keys + right->count + moved);
+                copy(left->keys + half, left->keys + left->count, right->keys);
+                right->count += moved;
+            }
+            left->count = half;
+            parent->keys[s] = right->keys[0];
+            return;
+        }
+    }
+    else{
+        Inner* left = (Inner*)parent->children[s];
+        Inner* right = (Inner*)parent->children[s + 1];
+        // Concatenate both nodes with the parent separator between them.
+        vector<Type> keys(left->keys, left->keys + left->count - 1);
+        keys.push_back(parent->keys[s]);
+        keys.insert(keys.end(), right->keys, right->keys + right->count - 1);
+        vector<void*> children(left->children, left->children + left->count);
+        children.insert(children.end(), right->children, right->children + right->count);
+
+        if(children.size() <= innerCapacity){
+            copy(keys.begin(), keys.end(), left->keys);
+            copy(children.begin(), children.end(), left->children);
+            left->count = children.size();
+            delete right;
+        }
+        else{
+            size_t half = children.size() / 2;
+            copy(keys.begin(), keys.begin() + half - 1, left->keys);
+            copy(children.begin(), children.begin() + half, left->children);
+            left->count = half;
+            parent->keys[s] = keys[half - 1];
+            copy(keys.begin() + half, keys.end(), right->keys);
+            copy(children.begin() + half, children.end(), right->children);
+            right->count = children.size() - half;
+            return;
+        }
+    }
+
+    // The right node was merged into the left one: remove it from the parent.
+    copy(parent->keys + s + 1, parent->keys + parent->count - 1, parent->keys + s);
+    copy(parent->children + s + 2, parent->children + parent->count, parent->children + s + 1);
+    parent->count--;
+
+    if(depth == 0){
+        // A root with a single child is replaced by the child.
+        if(parent->count == 1){
+            root = parent->children[0];
+            levels--;
+            delete parent;
+        }
+    }
+    else if(parent->count < innerMinimum)
+        rebalance(path, depth - 1);
+}
+
+template <class Type>
+void SortedTree<Type>::bulkLoad(const Type arrListSorted[], size_t num){
+    build(vector<Type>(arrListSorted, arrListSorted + num));
+}
+
+template <class Type>
+void SortedTree<Type>::build(const vector<Type>& sorted){
+    destroy(root, levels);
+    num = sorted.size();
+    levels = 0;
+
+    // Leaves, with the elements spread evenly so that the last one is not nearly empty.
+    size_t fill = leafCapacity * 3 / 4;
+    size_t leafCount = max((size_t)1, (num + fill - 1) / fill);
+    vector<void*> nodes(leafCount);
+    vector<Type> firstKeys(leafCount);
+    Leaf* previous = 0;
+    for(size_t l = 0; l < leafCount; l++){
+        Leaf* leaf = new Leaf;
+        size_t first = num * l / leafCount, last = num * (l + 1) / leafCount;
+        copy(sorted.begin() + first, sorted.begin() + last, leaf->keys);
+        leaf->count = last - first;
+        leaf->next = 0;
+        if(previous)
+            previous->next = leaf;
+        previous = leaf;
+        nodes[l] = leaf;
+        if(leaf->count)
+            firstKeys[l] = leaf->keys[0];
+    }
+
+    // Inner levels, each separating its children by their first keys, until one node is left.
+    fill = innerCapacity * 3 / 4;
+    while(nodes.size() > 1){
+        size_t innerCount = (nodes.size() + fill - 1) / fill;
+        vector<void*> parents(innerCount);
+        vector<Type> parentKeys(innerCount);
+        for(size_t p = 0; p < innerCount; p++){
+            Inner* inner = new Inner;
+            size_t first = nodes.size() * p / innerCount, last = nodes.size() * (p + 1) / innerCount;
+            inner->count = last - first;
+            copy(nodes.begin() + first, nodes.begin() + last, inner->children);
+            copy(firstKeys.begin() + first + 1, firstKeys.begin() + last, inner->keys);
+            parents[p] = inner;
+            parentKeys[p] = firstKeys[first];
+        }
+        nodes.swap(parents);
+        firstKeys.swap(parentKeys);
+        levels++;
+    }
+    root = nodes[0];
+}
+
+template <class Type>
+void SortedTree<Type>::applyBatch(const Type inserts[], size_t numInserts, const Type erases[], size_t numErases){
+    vector<Type> sortedInserts(inserts, inserts + numInserts);
+    vector<Type> sortedErases(erases, erases + numErases);
+    sort(sortedInserts.begin(), sortedInserts.end());
+    sort(sortedErases.begin(), sortedErases.end());
+
+    if((numInserts + numErases) * 8 <= num){
+        // Sorted order walks neighbouring leaves one after the other, which keeps them in cache.
+        for(size_t i = 0; i < numInserts; i++)
+            insert(sortedInserts[i]);
+        for(size_t i = 0; i < numErases; i++)
+            erase(sortedErases[i]);
+        return;
+    }
+
+    vector<Type> merged;
+    merged.reserve(num + numInserts);
+    vector<Type> current = toVector();
+    std::merge(current.begin(), current.end(), sortedInserts.begin(), sortedInserts.end(), back_inserter(merged));
+    // Remove one element per erase, as erase() does.
+    vector<Type> remaining;
+    remaining.reserve(merged.size());
+    set_difference(merged.begin(), merged.end(), sortedErases.begin(), sortedErases.end(), back_inserter(remaining));
+    build(remaining);
+}
+
+template <class Type>
+template <class Visitor>
+void SortedTree<Type>::forEach(Visitor visit) const{
+    for(const Leaf* leaf = firstLeaf(); leaf; leaf = leaf->next){
+        for(size_t i = 0; i < leaf->count; i++)
+            visit(leaf->keys[i]);
+    }
+}
+
+template <class Type>
+vector<Type> SortedTree<Type>::toVector() const{
+    vector<Type> elements;
+    elements.reserve(num);
+    for(const Leaf* leaf = firstLeaf(); leaf; leaf = leaf->next)
+        elements.insert(elements.end(), leaf->keys, leaf->keys + leaf->count);
+    return elements;
+}
+
+template <class Type>
+bool SortedTree<Type>::validate() const{
+    vector<const Leaf*> leaves;
+    if(!validateNode(root, levels, 0, 0, leaves))
+        return false;
+    size_t total = 0;
+    for(size_t l = 0; l < leaves.size(); l++){
+        // The chain must visit the leaves in the order of the tree, and stop after the last one.
+        const Leaf* next = l + 1 < leaves.size() ? leaves[l + 1] : 0;
+        if(leaves[l]->next != next)
+            return false;
+        if(next && leaves[l]->count && next->count && next->keys[0] < leaves[l]->keys[leaves[l]->count - 1])
+            return false;
+        total += leaves[l]->count;
+    }
+    return total == num;
+}
+
+template <class Type>
+bool SortedTree<Type>::validateNode(const void* node, size_t level, const Type* lower, const Type* upper, vector<const Leaf*>& leaves) const{
+    bool isRoot = node == root;
+    if(level == 0){
+        const Leaf* leaf = (const Leaf*)node;
+        if(leaf->count > leafCapacity || (!isRoot && leaf->count < leafMinimum))
+            return false;
+        for(size_t i = 0; i < leaf->count; i++){
+            if((i > 0 && leaf->keys[i] < leaf->keys[i - 1]) || (lower && leaf->keys[i] < *lower) || (upper && *upper < leaf->keys[i]))
+                return false;
+        }
+        leaves.push_back(leaf);
+        return true;
+    }
+
+    const Inner* inner = (const Inner*)node;
+    if(inner->count > innerCapacity || inner->count < (isRoot ? 2 : innerMinimum))
+        return false;
+    for(size_t i = 0; i + 1 < inner->count; i++){
+        if((i > 0 && inner->keys[i] < inner->keys[i - 1]) || (lower && inner->keys[i] < *lower) || (upper && *upper < inner->keys[i]))
+            return false;
+    }
+    for(size_t i = 0; i < inner->count; i++){
+        const Type* childLower = i > 0 ? &inner->keys[i - 1] : lower;
+        const Type* childUpper = i + 1 < inner->count ? &inner->keys[i] : upper;
+        if(!validateNode(inner->children[i], level - 1, childLower, childUpper, leaves))
+            return false;
+    }
+    return true;
+}
+
+#endif // SORTEDTREE_H
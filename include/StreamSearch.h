@@ -0,0 +1,138 @@
+#ifndef STREAMSEARCH_H
+#define STREAMSEARCH_H
+
+#include <SimdSearch.h>
+#include <SequenceSearch.h>
+#include <vector>
+#include <cstddef>
+using namespace std;
+
+// Searches over a stream of elements that never has to be in memory as a whole.
+// The stream is pushed chunk by chunk; each push() returns the matches found in that chunk,
+// as offsets from the start of the whole stream. The state kept between chunks is fixed in
+// size, so memory does not grow with the length of the stream.
+
+// Stream version of SearchingAlgo::linearSearch.
+template <class Type>
+class StreamLinearSearch {
+    public:
+        // Value returned by firstOffset() while there has been no match.
+        static const size_t npos = (size_t)-1;
+
+        explicit StreamLinearSearch(const Type& item) : item(item) { reset(); }
+
+        // Start a new stream.
+        void reset();
+
+        // Scan the next count elements of the stream.
+        // Return the stream offsets of the elements equal to item in this chunk.
+        // Time complexity: O(count), with SIMD compares for 32/64-bit integers, float and double.
+        vector<size_t> push(const Type chunk[], size_t count);
+
+        bool found() const { return matches > 0; }
+        size_t firstOffset() const { return first; }
+        size_t matchCount() const { return matches; }
+        // Number of elements pushed so far.
+        size_t position() const { return consumed; }
+
+    private:
+        Type item;
+        size_t consumed;
+        size_t matches;
+        size_t first;
+};
+
+template <class Type>
+const size_t StreamLinearSearch<Type>::npos;
+
+template <class Type>
+void StreamLinearSearch<Type>::reset(){
+    consumed = 0;
+    matches = 0;
+    first = npos;
+}
+
+template <class Type>
+vector<size_t> StreamLinearSearch<Type>::push(const Type chunk[], size_t count){
+    vector<size_t> offsets;
+    for(size_t i = simdFind(chunk, count, item); i < count; ){
+        offsets.push_back(consumed + i);
+        i++;
+        // simdFind() returns the number of elements searched if there is no match.
+        i += simdFind(chunk + i, count - i, item);
+    }
+    if(first == npos && !offsets.empty())
+        first = offsets[0];
+    matches += offsets.size();
+    consumed += count;
+    return offsets;
+}
+
+// Stream version of SearchingAlgo::sublistSearch.
+// The pattern is matched with SequenceMatcher (Knuth-Morris-Pratt); the number of pattern
+// elements matched at the end of a chunk is carried over to the next one, so occurrences that
+// straddle two or more chunks are found. Memory: O(m) for a pattern of m elements.
+template <class Type>
+class StreamSublistSearch {
+    public:
+        static const size_t npos = (size_t)-1;
+
+        // Preprocess the pattern [patternFirst, patternLast).
+        template <class Iterator>
+        StreamSublistSearch(Iterator patternFirst, Iterator patternLast) : matcher(patternFirst, patternLast) { reset(); }
+
+        void reset();
+
+        // Scan the next count elements of the stream.
+        // Return the stream offsets at which occurrences of the pattern that end in this chunk
+        // start, in ascending order. Occurrences may overlap. An empty pattern occurs at the
+        // offset of every element.
+        // Time complexity: O(count) amortized.
+        vector<size_t> push(const Type chunk[], size_t count);
+
+        bool found() const { return matches > 0; }
+        size_t firstOffset() const { return first; }
+        size_t matchCount() const { return matches; }
+        size_t position() const { return consumed; }
+
+    private:
+        SequenceMatcher<Type> matcher;
+        // Number of pattern elements matched by the last elements pushed.
+        size_t matched;
+        size_t consumed;
+        size_t matches;
+        size_t first;
+};
+
+template <class Type>
+const size_t StreamSublistSearch<Type>::npos;
+
+template <class Type>
+void StreamSublistSearch<Type>::reset(){
+    matched = 0;
+    consumed = 0;
+    matches = 0;
+    first = npos;
+}
+
+template <class Type>
+vector<size_t> StreamSublistSearch<Type>::push(const Type chunk[], size_t count){
+    vector<size_t> offsets;
+    size_t patternSize = matcher.patternSize();
+    for(size_t i = 0; i < count; i++){
+        if(patternSize == 0)
+            offsets.push_back(consumed + i);
+        else{
+            matched = matcher.advance(matched, chunk[i]);
+            if(matched == patternSize)
+                offsets.push_back(consumed + i + 1 - patternSize);
+        }
+    }
+    if(first == npos && !offsets.empty())
+        first = offsets[0];
+    matches += offsets.size();
+    consumed += count;
+    return offsets;
+}
+
+#endif // STREAMSEARCH_H
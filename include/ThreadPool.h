@@ -0,0 +1,146 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+using namespace std;
+
+// Fixed set of worker threads that stay alive between jobs, so that starting a parallel
+// search does not pay for thread creation. A job is a number of tasks numbered from 0;
+// the workers and the calling thread take tasks one at a time until none are left.
+class ThreadPool {
+    public:
+        // Start numThreads - 1 workers; the thread calling run() is the last one.
+        // 0 uses the number of hardware threads.
+        explicit ThreadPool(unsigned numThreads = 0);
+        ~ThreadPool();
+
+        // Number of threads taking part in a job, including the caller.
+        unsigned size() const { return workers.size() + 1; }
+
+        // Call task(i) for every i in [0, numTasks) and return when all calls have finished.
+        // Only one job runs at a time; concurrent calls to run() wait for each other.
+        // If a task throws, on any thread, the tasks not started yet are skipped, and the first
+        // exception is rethrown once every thread has left the job.
+        void run(size_t numTasks, const function<void(size_t)>& task);
+
+    private:
+        ThreadPool(const ThreadPool&);
+        ThreadPool& operator=(const ThreadPool&);
+
+        void workerLoop();
+        // Take tasks of the current job until there are none left. Exceptions of the tasks are
+        // caught: the first one is kept in error.
+        void runTasks();
+
+        vector<thread> workers;
+        mutex jobMutex;
+        mutex stateMutex;
+        condition_variable jobReady;
+        condition_variable jobDone;
+
+        // Current job, protected by stateMutex.
+        const function<void(size_t)>* task;
+        size_t numTasks;
+        // Incremented for every job, so that workers can tell a new job from a spurious wakeup.
+        unsigned long long generation;
+        // Workers still taking part in the current job.
+        unsigned busyWorkers;
+        // First exception thrown by a task of the current job.
+        exception_ptr error;
+        bool stopping;
+
+        atomic<size_t> nextTask;
+};
+
+inline ThreadPool::ThreadPool(unsigned numThreads)
+    : task(nullptr), numTasks(0), generation(0), busyWorkers(0), stopping(false), nextTask(0){
+    if(numThreads == 0)
+        numThreads = max(thread::hardware_concurrency(), 1u);
+    for(unsigned i = 1; i < numThreads; i++)
+        workers.push_back(thread(&ThreadPool::workerLoop, this));
+}
+
+inline ThreadPool::~ThreadPool(){
+    {
+        lock_guard<mutex> lock(stateMutex);
+        stopping = true;
+    }
+    jobReady.notify_all();
+    for(size_t i = 0; i < workers.size(); i++)
+        workers[i].join();
+}
+
+inline void ThreadPool::run(size_t numTasks, const function<void(size_t)>& task){
+    lock_guard<mutex> jobLock(jobMutex);
+
+    {
+        lock_guard<mutex> lock(stateMutex);
+        this->task = &task;
+        this->numTasks = numTasks;
+        nextTask = 0;
+        busyWorkers = workers.size();
+        generation++;
+    }
+    jobReady.notify_all();
+
+    // The caller works on the job as well.
+    runTasks();
+
+    exception_ptr failure;
+    {
+        // task refers to the caller's object: no worker may still use it after run() returns.
+        unique_lock<mutex> lock(stateMutex);
+        jobDone.wait(lock, [this](){ return busyWorkers == 0; });
+        this->task = nullptr;
+        failure = error;
+        error = nullptr;
+    }
+    if(failure)
+        rethrow_exception(failure);
+}
+
+inline void ThreadPool::runTasks(){
+    for(size_t i = nextTask++; i < numTasks; i = nextTask++){
+        try{
+            (*task)(i);
+        }
+        catch(...){
+            lock_guard<mutex> lock(stateMutex);
+            if(!error)
+                error = current_exception();
+            // Skip the tasks not started yet.
+            nextTask = numTasks;
+        }
+    }
+}
+
+inline void ThreadPool::workerLoop(){
+    unsigned long long seen = 0;
+    while(true){
+        {
+            unique_lock<mutex> lock(stateMutex);
+            jobReady.wait(lock, [this, seen](){ return stopping || generation != seen; });
+            if(stopping)
+                return;
+            seen = generation;
+        }
+
+        runTasks();
+
+        {
+            lock_guard<mutex> lock(stateMutex);
+            busyWorkers--;
+        }
+        jobDone.notify_one();
+    }
+}
+
+#endif // THREADPOOL_H
@@ -26,6 +26,14 @@ int main()
     cout << (objSearch.interpolationSearch(arrDemo, arrSize, item) ? "true" : "false") << endl;
     cout << (objSearch.recursiveLinearSearch(arrDemo, arrSize, item) ? "true" : "false") << endl;
 
+    // Position of item, and where 6.0 would be inserted to keep arrDemo sorted.
+    cout << objSearch.findPosition(arrDemo, arrSize, item, searchFibonacci) << endl;
+    cout << objSearch.lowerBound(arrDemo, arrSize, 6.0, searchExponential) << endl;
+
+    // Position of the element nearest to 6.3, and whether one lies within 0.1 of 6.45.
+    cout << objSearch.nearestSearch(arrDemo, arrSize, 6.3) << endl;
+    cout << (objSearch.approximateSearch(arrDemo, arrSize, 6.45, 0.1) ? "true" : "false") << endl;
+
     list<double> list1, list2;
     double random;
 
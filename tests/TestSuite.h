@@ -0,0 +1,53 @@
+#ifndef TESTSUITE_H
+#define TESTSUITE_H
+
+#include <iostream>
+#include <vector>
+#include <cstddef>
+using namespace std;
+
+// Minimal test registry for the searchingAlgoTests target.
+// TEST(name) { ... } defines a test that runs from testMain.cpp.
+// CHECK(condition) reports a failed condition and goes on; REQUIRE(condition) also ends the test,
+// for checks inside long randomized loops where one failure would be followed by many others.
+
+struct TestCase {
+    const char* name;
+    void (*run)();
+};
+
+inline vector<TestCase>& testCases(){
+    static vector<TestCase> cases;
+    return cases;
+}
+
+// Number of failed checks so far.
+inline size_t& testFailures(){
+    static size_t failures = 0;
+    return failures;
+}
+
+inline void testCheckFailed(const char* condition, const char* file, int line){
+    cerr << file << ":" << line << ": check failed: " << condition << endl;
+    testFailures()++;
+}
+
+struct TestRegistration {
+    TestRegistration(const char* name, void (*run)()){
+        TestCase test = { name, run };
+        testCases().push_back(test);
+    }
+};
+
+#define TEST(name) \
+    static void name(); \
+    static TestRegistration name##Registration(#name, name); \
+    static void name()
+
+#define CHECK(condition) \
+    do{ if(!(condition)) testCheckFailed(#condition, __FILE__, __LINE__); }while(0)
+
+#define REQUIRE(condition) \
+    do{ if(!(condition)){ testCheckFailed(#condition, __FILE__, __LINE__); return; } }while(0)
+
+#endif // TESTSUITE_H
@@ -0,0 +1,90 @@
+#include "TestSuite.h"
+#include <AdaptiveSearch.h>
+#include <random>
+#include <thread>
+using namespace std;
+
+TEST(adaptiveSearchMatchesLowerBound){
+    mt19937 rng(1);
+    for(size_t num : {0, 1, 2, 100, 5000}){
+        vector<int> arr(num);
+        for(size_t i = 0; i < num; i++)
+            arr[i] = rng() % (num * 4 + 1) - (int)num;
+        sort(arr.begin(), arr.end());
+        AdaptiveSearch<int> adaptive(arr.data(), num, 16, 256);
+        for(int round = 0; round < 2; round++){
+            for(int i = 0; i < 3000; i++){
+                int item = rng() % (num * 4 + 3) - (int)num - 1;
+                REQUIRE(adaptive.lowerBound(item) == (size_t)(lower_bound(arr.begin(), arr.end(), item) - arr.begin()));
+                adaptive.record(item);
+            }
+            // The second round runs on the method chosen from the recorded lookups.
+            adaptive.calibrate();
+        }
+    }
+}
+
+TEST(adaptiveSearchRecalibrationThreshold){
+    vector<double> arr(4096);
+    for(size_t i = 0; i < arr.size(); i++)
+        arr[i] = i * 0.5;
+    // 32 samples: one every 132 elements.
+    AdaptiveSearch<double> lenient(arr.data(), arr.size(), 32, 64, 0.25);
+    AdaptiveSearch<double> strict(arr.data(), arr.size(), 32, 64);
+    CHECK(!lenient.update(arr.data(), arr.size()));
+    CHECK(!strict.update(arr.data(), arr.size()));
+
+    // Shift the last quarter of the array: 8 of the 32 samples change.
+    for(size_t i = arr.size() * 3 / 4; i < arr.size(); i++)
+        arr[i] += 1;
+    CHECK(!lenient.update(arr.data(), arr.size()));
+    CHECK(strict.update(arr.data(), arr.size()));
+
+    // Half of the samples changed since the last calibration.
+    for(size_t i = arr.size() / 2; i < arr.size(); i++)
+        arr[i] += 1;
+    CHECK(lenient.update(arr.data(), arr.size()));
+    CHECK(!lenient.update(arr.data(), arr.size()));
+    // A new size always calibrates again.
+    CHECK(lenient.update(arr.data(), arr.size() - 1));
+}
+
+// Element without arithmetic: calibration cannot make missing keys, and uses the array keys.
+TEST(adaptiveSearchStrings){
+    vector<string> arr;
+    for(int i = 0; i < 500; i++)
+        arr.push_back(to_string(100000 + i * 3));
+    AdaptiveSearch<string> adaptive(arr.data(), arr.size());
+    CHECK(adaptive.search("100003"));
+    CHECK(!adaptive.search("100004"));
+    adaptive.calibrate();
+    CHECK(adaptive.search(arr.back()));
+    CHECK(adaptive.method() != searchInterpolation);
+}
+
+// Lookups do not write to the selector: threads can share one while nothing records or calibrates.
+TEST(adaptiveSearchConcurrentLookups){
+    vector<long long> arr(20000);
+    for(size_t i = 0; i < arr.size(); i++)
+        arr[i] = (long long)i * 3;
+    AdaptiveSearch<long long> adaptive(arr.data(), arr.size());
+    for(long long item = 0; item < 4096; item++)
+        adaptive.record(item * 7);
+    adaptive.calibrate();
+
+    const AdaptiveSearch<long long>& shared = adaptive;
+    vector<size_t> wrong(4, 0);
+    vector<thread> threads;
+    for(size_t t = 0; t < wrong.size(); t++){
+        threads.push_back(thread([&shared, &arr, &wrong, t](){
+            for(long long item = (long long)t; item < 60000; item += 5){
+                size_t expected = lower_bound(arr.begin(), arr.end(), item) - arr.begin();
+                wrong[t] += shared.lowerBound(item) != expected || shared.search(item) != (item % 3 == 0);
+            }
+        }));
+    }
+    for(size_t t = 0; t < threads.size(); t++)
+        threads[t].join();
+    for(size_t t = 0; t < wrong.size(); t++)
+        CHECK(wrong[t] == 0);
+}
@@ -0,0 +1,83 @@
+#include "TestSuite.h"
+#include <ConcurrentIndex.h>
+#include <thread>
+#include <cstdint>
+using namespace std;
+
+// Readers check that every version they see is whole while a writer publishes in a loop:
+// every element of version v equals v, and a reader never sees the versions go backwards,
+// nor a version older than one already published.
+// A version freed too early, or published half built, breaks one of these under the
+// AddressSanitizer and ThreadSanitizer targets, or fails the checks directly.
+TEST(concurrentIndexReadersAndWriter){
+    const size_t numReaders = 4, numPublishes = 2000, versionSize = 256;
+    ConcurrentIndex<uint64_t> index(numReaders);
+    atomic<bool> writerDone(false);
+    atomic<size_t> brokenVersions(0), versionsBackwards(0), staleVersions(0);
+
+    vector<thread> readers;
+    for(size_t r = 0; r < numReaders; r++){
+        readers.push_back(thread([&](){
+            ConcurrentIndex<uint64_t>::Reader reader = index.reader();
+            uint64_t lastSeen = 0;
+            while(!writerDone.load()){
+                // A version already published when a read starts is the oldest it may see.
+                uint64_t published = index.version();
+                reader.read([&](const uint64_t* elements, size_t num, uint64_t versionNumber){
+                    if(versionNumber < published)
+                        staleVersions++;
+                    if(versionNumber < lastSeen)
+                        versionsBackwards++;
+                    lastSeen = versionNumber;
+                    if(num != (versionNumber == 0 ? 0 : versionSize))
+                        brokenVersions++;
+                    for(size_t i = 0; i < num; i++){
+                        if(elements[i] != versionNumber){
+                            brokenVersions++;
+                            break;
+                        }
+                    }
+                });
+                // Every element of a version at least as new as published is >= published.
+                published = index.version();
+                if(reader.lowerBound(published) != 0)
+                    staleVersions++;
+            }
+        }));
+    }
+
+    for(uint64_t v = 1; v <= numPublishes; v++){
+        vector<uint64_t> elements(versionSize, v);
+        index.publish(move(elements));
+        if(v % 64 == 0)
+            this_thread::yield();
+    }
+    writerDone.store(true);
+    for(size_t r = 0; r < readers.size(); r++)
+        readers[r].join();
+
+    CHECK(brokenVersions == 0);
+    CHECK(versionsBackwards == 0);
+    CHECK(staleVersions == 0);
+    CHECK(index.version() == numPublishes);
+    // No reader is left: every retired version can be freed.
+    CHECK(index.reclaim() == 0);
+}
+
+// A reader in the middle of read() keeps its version alive across publishes.
+TEST(concurrentIndexRetiredWhileRead){
+    ConcurrentIndex<int> index(2);
+    int first[] = {1, 1, 1};
+    index.publish(first, 3);
+    ConcurrentIndex<int>::Reader reader = index.reader();
+    reader.read([&](const int* elements, size_t num, uint64_t versionNumber){
+        int second[] = {2, 2, 2};
+        index.publish(second, 3);
+        index.publish(second, 3);
+        CHECK(index.reclaim() == 2);
+        CHECK(versionNumber == 1 && num == 3 && elements[0] == 1 && elements[2] == 1);
+    });
+    CHECK(index.reclaim() == 0);
+    CHECK(reader.search(2));
+    CHECK(!reader.search(1));
+}
@@ -0,0 +1,104 @@
+#include "TestSuite.h"
+#include <SearchingAlgo.h>
+#include <MultiSequenceSearch.h>
+#include <random>
+using namespace std;
+
+// Element without std::hash, so that symbols are found by binary search.
+struct UnhashedSymbol {
+    int value;
+
+    UnhashedSymbol(int value = 0) : value(value) {}
+    bool operator<(const UnhashedSymbol& other) const { return value < other.value; }
+    bool operator==(const UnhashedSymbol& other) const { return value == other.value; }
+};
+
+// Compare findAll and containsEach with one sequenceSearch per pattern, on random pattern sets:
+// patterns are cut out of the text half of the time, so that they do occur, and drawn at random
+// otherwise. alphabetSize sets how deep and how bushy the automaton gets.
+template <class Type>
+static void compareWithSequenceSearch(unsigned seed, int alphabetSize, size_t numPatterns, size_t maxLength, size_t textSize){
+    mt19937 rng(seed);
+    SearchingAlgo<Type> objSearch;
+    vector<Type> text(textSize);
+    for(size_t i = 0; i < textSize; i++)
+        text[i] = Type(rng() % alphabetSize);
+
+    for(int round = 0; round < 10; round++){
+        vector<vector<Type> > patterns(numPatterns);
+        for(size_t p = 0; p < numPatterns; p++){
+            size_t length = rng() % (maxLength + 1);
+            if(rng() % 2 && length <= textSize){
+                size_t start = rng() % (textSize - length + 1);
+                patterns[p].assign(text.begin() + start, text.begin() + start + length);
+            }
+            else{
+                for(size_t i = 0; i < length; i++)
+                    patterns[p].push_back(Type(rng() % (alphabetSize + 2)));
+            }
+        }
+        MultiSequenceMatcher<Type> matcher(patterns);
+
+        vector<pair<size_t, size_t> > expected;
+        vector<bool> expectedContained(numPatterns);
+        for(size_t p = 0; p < numPatterns; p++){
+            vector<size_t> offsets = objSearch.sequenceSearch(text.data(), textSize, patterns[p].data(), patterns[p].size());
+            for(size_t i = 0; i < offsets.size(); i++)
+                expected.push_back(make_pair(offsets[i] + patterns[p].size(), p));
+            expectedContained[p] = !offsets.empty();
+        }
+        vector<pair<size_t, size_t> > found;
+        vector<typename MultiSequenceMatcher<Type>::Match> matches = matcher.findAll(text.begin(), text.end());
+        for(size_t i = 0; i < matches.size(); i++)
+            found.push_back(make_pair(matches[i].offset + patterns[matches[i].pattern].size(), matches[i].pattern));
+        // Matches come ordered by end position; the order of patterns ending together is free.
+        bool ordered = true;
+        for(size_t i = 1; i < found.size(); i++)
+            ordered = ordered && found[i - 1].first <= found[i].first;
+        REQUIRE(ordered);
+        sort(expected.begin(), expected.end());
+        sort(found.begin(), found.end());
+        REQUIRE(found == expected);
+
+        REQUIRE(matcher.containsEach(text.begin(), text.end()) == expectedContained);
+    }
+}
+
+TEST(multiSequenceSmallAlphabet){
+    // Every level of the automaton fits in dense rows.
+    compareWithSequenceSearch<int>(1, 2, 30, 8, 2000);
+    compareWithSequenceSearch<char>(2, 4, 200, 12, 3000);
+}
+
+TEST(multiSequenceLargeAlphabet){
+    // Only the root and maybe the first level are dense: steps go through sparse children
+    // and failure links.
+    compareWithSequenceSearch<int>(3, 20, 500, 10, 5000);
+    compareWithSequenceSearch<long long>(4, 3000, 400, 6, 5000);
+}
+
+TEST(multiSequenceUnhashedElements){
+    compareWithSequenceSearch<UnhashedSymbol>(5, 3, 100, 10, 3000);
+    compareWithSequenceSearch<UnhashedSymbol>(6, 500, 300, 5, 5000);
+}
+
+TEST(multiSequenceMemoryBound){
+    // 40000 patterns over 40000 distinct elements: a dense table would take
+    // 4 * 40001 * 40001 bytes, about 6 GB.
+    mt19937 rng(7);
+    vector<vector<int> > patterns(40000);
+    for(size_t p = 0; p < patterns.size(); p++){
+        patterns[p].push_back(p);
+        for(size_t i = 0; i < 4; i++)
+            patterns[p].push_back(rng() % 40000);
+    }
+    MultiSequenceMatcher<int> matcher(patterns);
+    CHECK(matcher.stateCount() > 160000);
+    CHECK(matcher.denseStateCount() == 1);
+    CHECK(matcher.memoryBytes() < 16 * 1024 * 1024);
+
+    vector<int> text(patterns[123]);
+    text.insert(text.end(), patterns[4567].begin(), patterns[4567].end());
+    vector<MultiSequenceMatcher<int>::Match> matches = matcher.findAll(text.begin(), text.end());
+    CHECK(matches.size() == 2 && matches[0].pattern == 123 && matches[0].offset == 0 && matches[1].pattern == 4567 && matches[1].offset == 5);
+}
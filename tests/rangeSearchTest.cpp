@@ -0,0 +1,54 @@
+#include "TestSuite.h"
+#include <RangeSearch.h>
+#include <random>
+using namespace std;
+
+struct KeyedRecord {
+    long long key;
+    long long payload;
+};
+
+TEST(rangeSearchMatchesStdBounds){
+    mt19937 rng(1);
+    const SearchMethod methods[] = { searchBinary, searchJump, searchInterpolation, searchExponential, searchFibonacci };
+    for(size_t num : {0, 1, 2, 7, 100, 4097}){
+        vector<KeyedRecord> records(num);
+        for(size_t i = 0; i < num; i++)
+            records[i] = KeyedRecord{(long long)(rng() % (num + 1) * 3), (long long)i};
+        sort(records.begin(), records.end(), [](const KeyedRecord& a, const KeyedRecord& b){ return a.key < b.key; });
+        vector<long long> descending(num);
+        for(size_t i = 0; i < num; i++)
+            descending[i] = records[num - 1 - i].key;
+
+        for(long long value = -1; value <= (long long)num * 3 + 1; value++){
+            auto lower = ranges::lower_bound(records, value, {}, &KeyedRecord::key);
+            auto upper = ranges::upper_bound(records, value, {}, &KeyedRecord::key);
+            auto lowerDescending = ranges::lower_bound(descending, value, greater<>());
+            for(SearchMethod method : methods){
+                REQUIRE(rangeLowerBound(records, value, {}, &KeyedRecord::key, method) == lower);
+                REQUIRE(rangeUpperBound(records, value, {}, &KeyedRecord::key, method) == upper);
+                REQUIRE(rangeLowerBound(descending, value, greater<>(), {}, method) == lowerDescending);
+            }
+        }
+    }
+}
+
+// Keys and values of different types are compared after the usual conversions: -5 becomes a
+// large unsigned value, and interpolation has to place it where the comparisons do.
+TEST(rangeSearchMixedKeyTypes){
+    const SearchMethod methods[] = { searchBinary, searchJump, searchInterpolation, searchExponential, searchFibonacci };
+    // Spread over the whole unsigned range, so that -5 falls between two keys.
+    vector<unsigned> keys;
+    for(unsigned i = 0; i < 1000; i++)
+        keys.push_back(i * 4294967u);
+    keys.push_back(4294967295u);
+    vector<float> floats(keys.begin(), keys.end());
+    for(int value : {-5, -1, 0, 3, 4294967, 2147483647, -2147483647 - 1}){
+        auto lower = ranges::lower_bound(keys, value, ranges::less{});
+        auto lowerFloat = ranges::lower_bound(floats, value, ranges::less{});
+        for(SearchMethod method : methods){
+            CHECK(rangeLowerBound(keys, value, ranges::less{}, identity{}, method) == lower);
+            CHECK(rangeLowerBound(floats, value, ranges::less{}, identity{}, method) == lowerFloat);
+        }
+    }
+}
@@ -0,0 +1,84 @@
+#include "TestSuite.h"
+#include <SearchingAlgo.h>
+#include <stdexcept>
+using namespace std;
+
+// Key whose comparisons can throw, and check that the searcher in use keeps its lookup cache
+// and Bloom filter attached while it compares.
+struct ProbedKey {
+    int value;
+
+    static const SearchingAlgo<ProbedKey>* searcher;
+    static bool throwing;
+    static size_t detachedDuringSearch;
+
+    ProbedKey(int value = 0) : value(value) {}
+    bool operator<(const ProbedKey& other) const { return compared(value < other.value); }
+    bool operator>(const ProbedKey& other) const { return compared(value > other.value); }
+    bool operator==(const ProbedKey& other) const { return compared(value == other.value); }
+
+    static bool compared(bool result){
+        if(searcher && (!searcher->lookupCache() || !searcher->bloomFilter()))
+            detachedDuringSearch++;
+        if(throwing)
+            throw runtime_error("comparison failed");
+        return result;
+    }
+};
+
+const SearchingAlgo<ProbedKey>* ProbedKey::searcher = 0;
+bool ProbedKey::throwing = false;
+size_t ProbedKey::detachedDuringSearch = 0;
+
+namespace std {
+    template <>
+    struct hash<ProbedKey> {
+        size_t operator()(const ProbedKey& key) const { return hash<int>()(key.value); }
+    };
+}
+
+TEST(searchingAlgoCacheAndFilterStayAttached){
+    typedef bool (SearchingAlgo<ProbedKey>::*Search)(ProbedKey[], int, const ProbedKey&);
+    const Search searches[] = { &SearchingAlgo<ProbedKey>::binarySearch, &SearchingAlgo<ProbedKey>::jumpSearch,
+                                &SearchingAlgo<ProbedKey>::interpolationSearch, &SearchingAlgo<ProbedKey>::exponentialSearch,
+                                &SearchingAlgo<ProbedKey>::fibonacciSearch };
+    vector<ProbedKey> arr;
+    for(int i = 0; i < 1000; i++)
+        arr.push_back(ProbedKey(i * 2));
+    int num = arr.size();
+
+    for(size_t s = 0; s < sizeof(searches) / sizeof(searches[0]); s++){
+        SearchingAlgo<ProbedKey> objSearch;
+        LookupCache<ProbedKey> cache(64);
+        BloomFilter<ProbedKey> filter(arr.data(), num);
+        objSearch.setLookupCache(&cache);
+        objSearch.setBloomFilter(&filter);
+        ProbedKey::searcher = &objSearch;
+        ProbedKey::detachedDuringSearch = 0;
+
+        CHECK((objSearch.*searches[s])(arr.data(), num, ProbedKey(500)));
+        CHECK(ProbedKey::detachedDuringSearch == 0);
+
+        // A search that throws leaves the cache and the filter attached, and caches nothing.
+        ProbedKey::throwing = true;
+        bool thrown = false;
+        try{
+            (objSearch.*searches[s])(arr.data(), num, ProbedKey(700));
+        }
+        catch(const runtime_error&){
+            thrown = true;
+        }
+        ProbedKey::throwing = false;
+        CHECK(thrown);
+        CHECK(objSearch.lookupCache() == &cache);
+        CHECK(objSearch.bloomFilter() == &filter);
+
+        // Both searches are then answered as usual: the first one from the cache.
+        size_t hits = cache.hits();
+        CHECK((objSearch.*searches[s])(arr.data(), num, ProbedKey(500)));
+        CHECK(cache.hits() == hits + 1);
+        CHECK((objSearch.*searches[s])(arr.data(), num, ProbedKey(700)));
+        CHECK(ProbedKey::detachedDuringSearch == 0);
+        ProbedKey::searcher = 0;
+    }
+}
@@ -0,0 +1,54 @@
+#include "TestSuite.h"
+#include <SimdSearch.h>
+#include <vector>
+using namespace std;
+
+// Check find(arr, num, item) against scalarFind for every length up to maxNum, with item at
+// every position, twice, and missing. The array has exactly num elements, so that the address
+// sanitizer catches a kernel reading past the end.
+template <class Type, class Find>
+static bool findMatchesScalar(Find find, size_t maxNum){
+    for(size_t num = 0; num <= maxNum; num++){
+        vector<Type> arr(num);
+        for(size_t i = 0; i < num; i++)
+            arr[i] = (Type)(i * 3 + 1);
+        for(size_t pos = 0; pos <= num; pos++){
+            Type item = pos < num ? arr[pos] : (Type)0;
+            if(find(arr.data(), num, item) != scalarFind(arr.data(), 0, num, item))
+                return false;
+        }
+        if(num >= 2){
+            arr[num - 1] = arr[num / 2];
+            if(find(arr.data(), num, arr[num / 2]) != num / 2)
+                return false;
+        }
+    }
+    return true;
+}
+
+template <class Type>
+static size_t findAny(const Type arr[], size_t num, Type item){
+    return simdFind(arr, num, item);
+}
+
+TEST(simdFindMatchesScalarFind){
+    CHECK(findMatchesScalar<int>(findAny<int>, 80));
+    CHECK(findMatchesScalar<unsigned>(findAny<unsigned>, 80));
+    CHECK(findMatchesScalar<long long>(findAny<long long>, 80));
+    CHECK(findMatchesScalar<float>(findAny<float>, 80));
+    CHECK(findMatchesScalar<double>(findAny<double>, 80));
+    CHECK(findMatchesScalar<short>(findAny<short>, 80));
+#ifdef SEARCHINGALGO_X86_SIMD
+    // simdFind only runs the best kernel of the CPU: check the others directly.
+    CHECK(findMatchesScalar<int32_t>(findInt32SSE2, 80));
+    CHECK(findMatchesScalar<float>(findFloatSSE2, 80));
+    CHECK(findMatchesScalar<int64_t>(findInt64SSE2, 80));
+    CHECK(findMatchesScalar<double>(findDoubleSSE2, 80));
+    if(detectSimdLevel() != simdSSE2){
+        CHECK(findMatchesScalar<int32_t>(findInt32AVX2, 80));
+        CHECK(findMatchesScalar<float>(findFloatAVX2, 80));
+        CHECK(findMatchesScalar<int64_t>(findInt64AVX2, 80));
+        CHECK(findMatchesScalar<double>(findDoubleAVX2, 80));
+    }
+#endif
+}
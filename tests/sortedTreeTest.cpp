@@ -0,0 +1,110 @@
+#include "TestSuite.h"
+#include <SortedTree.h>
+#include <set>
+#include <random>
+using namespace std;
+
+// Element of 64 bytes: leaves of 16 elements, so that a few thousand elements already make
+// a tree of several levels, and every split, merge and refill path is taken often.
+struct WideKey {
+    int key;
+    char padding[60];
+
+    WideKey(int key = 0) : key(key), padding() {}
+    bool operator<(const WideKey& other) const { return key < other.key; }
+    bool operator==(const WideKey& other) const { return key == other.key; }
+};
+
+template <class Type>
+static bool sameElements(const SortedTree<Type>& tree, const multiset<Type>& reference){
+    vector<Type> elements = tree.toVector();
+    return elements.size() == reference.size() && equal(elements.begin(), elements.end(), reference.begin());
+}
+
+// Random inserts, erases and searches, compared with multiset, in three phases: growing,
+// shrinking down to an empty tree, and growing again around a changing size.
+// Keys come from a small range so that runs of equal elements span several leaves.
+// The whole structure is validated after every erase, where nodes are merged and refilled.
+template <class Type>
+static void randomUpdates(unsigned seed, size_t operations, int keyRange, size_t validateEvery){
+    mt19937 rng(seed);
+    SortedTree<Type> tree;
+    multiset<Type> reference;
+    for(size_t op = 0; op < operations; op++){
+        size_t phase = op * 3 / operations;
+        unsigned insertPercent = phase == 0 ? 70 : phase == 1 ? 25 : 50;
+        int key = rng() % keyRange;
+        unsigned choice = rng() % 100;
+        if(choice < insertPercent){
+            tree.insert(Type(key));
+            reference.insert(Type(key));
+        }
+        else if(choice < 90){
+            typename multiset<Type>::iterator found = reference.find(Type(key));
+            bool expected = found != reference.end();
+            if(expected)
+                reference.erase(found);
+            REQUIRE(tree.erase(Type(key)) == expected);
+            if(op % validateEvery == 0)
+                REQUIRE(tree.validate());
+        }
+        else
+            REQUIRE(tree.search(Type(key)) == (reference.count(Type(key)) > 0));
+        REQUIRE(tree.size() == reference.size());
+    }
+    CHECK(tree.validate());
+    CHECK(sameElements(tree, reference));
+
+    // Empty the tree completely: the root must go back to a single leaf.
+    vector<Type> remaining(reference.begin(), reference.end());
+    shuffle(remaining.begin(), remaining.end(), rng);
+    for(size_t i = 0; i < remaining.size(); i++){
+        REQUIRE(tree.erase(remaining[i]));
+        if(i % validateEvery == 0)
+            REQUIRE(tree.validate());
+    }
+    CHECK(tree.empty());
+    CHECK(tree.height() == 0);
+    CHECK(tree.validate());
+}
+
+TEST(sortedTreeRandomUpdatesWide){
+    randomUpdates<WideKey>(1, 60000, 2000, 1);
+}
+
+TEST(sortedTreeRandomUpdatesInt){
+    randomUpdates<int>(2, 400000, 50000, 97);
+}
+
+TEST(sortedTreeBulkLoadAndBatches){
+    mt19937 rng(3);
+    for(size_t num : {0, 1, 15, 16, 17, 240, 5000, 100000}){
+        vector<WideKey> sorted(num);
+        for(size_t i = 0; i < num; i++)
+            sorted[i] = WideKey(rng() % 100000);
+        sort(sorted.begin(), sorted.end());
+        SortedTree<WideKey> tree;
+        tree.bulkLoad(sorted.data(), num);
+        REQUIRE(tree.validate());
+        multiset<WideKey> reference(sorted.begin(), sorted.end());
+        CHECK(sameElements(tree, reference));
+
+        // Small batches go through insert and erase, large ones through a rebuild.
+        for(size_t batchSize : {num / 100 + 1, num / 2 + 1}){
+            vector<WideKey> inserts(batchSize), erases(batchSize);
+            for(size_t i = 0; i < batchSize; i++){
+                inserts[i] = WideKey(rng() % 100000);
+                erases[i] = sorted.empty() ? WideKey(rng() % 100000) : sorted[rng() % sorted.size()];
+            }
+            tree.applyBatch(inserts.data(), batchSize, erases.data(), batchSize);
+            reference.insert(inserts.begin(), inserts.end());
+            for(size_t i = 0; i < batchSize; i++){
+                typename multiset<WideKey>::iterator found = reference.find(erases[i]);
+                if(found != reference.end())
+                    reference.erase(found);
+            }
+            REQUIRE(tree.validate());
+            CHECK(sameElements(tree, reference));
+        }
+    }
+}
@@ -0,0 +1,21 @@
+#include "TestSuite.h"
+#include <cstring>
+using namespace std;
+
+// Run every registered test, or those whose name contains the first argument.
+// The exit status is 1 if any check failed.
+int main(int argc, char* argv[])
+{
+    size_t run = 0;
+    for(size_t i = 0; i < testCases().size(); i++){
+        const TestCase& test = testCases()[i];
+        if(argc > 1 && !strstr(test.name, argv[1]))
+            continue;
+        size_t failuresBefore = testFailures();
+        test.run();
+        cout << test.name << (testFailures() == failuresBefore ? ": ok" : ": FAILED") << endl;
+        run++;
+    }
+    cout << run << " tests, " << testFailures() << " failed checks" << endl;
+    return testFailures() == 0 ? 0 : 1;
+}
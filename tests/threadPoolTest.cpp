@@ -0,0 +1,57 @@
+#include "TestSuite.h"
+#include <ThreadPool.h>
+#include <ParallelSearch.h>
+#include <stdexcept>
+using namespace std;
+
+// A task throwing on any thread makes run() throw once every thread has left the job, and the
+// pool stays usable for the next jobs.
+TEST(threadPoolRethrowsTaskExceptions){
+    ThreadPool pool(4);
+    for(size_t failing : {0, 1, 5, 63}){
+        atomic<size_t> started(0);
+        bool thrown = false;
+        try{
+            pool.run(64, [&](size_t i){
+                started++;
+                if(i == failing)
+                    throw runtime_error("task failed");
+                this_thread::yield();
+            });
+        }
+        catch(const runtime_error&){
+            thrown = true;
+        }
+        CHECK(thrown);
+        CHECK(started >= 1 && started <= 64);
+
+        atomic<size_t> done(0);
+        pool.run(100, [&](size_t){ done++; });
+        CHECK(done == 100);
+    }
+
+    // Every task throws: only one exception comes out.
+    bool thrown = false;
+    try{
+        pool.run(16, [](size_t){ throw logic_error("every task fails"); });
+    }
+    catch(const logic_error&){
+        thrown = true;
+    }
+    CHECK(thrown);
+}
+
+TEST(parallelSearchMatchesSequentialScan){
+    ParallelSearch<int> search(4);
+    vector<int> arr(ParallelSearch<int>::sequentialLimit * 3 + 17);
+    for(size_t i = 0; i < arr.size(); i++)
+        arr[i] = i % 1000;
+    for(int item : {-1, 0, 999, 500}){
+        size_t first = find(arr.begin(), arr.end(), item) - arr.begin();
+        CHECK(search.linearSearch(arr.data(), arr.size(), item) == (first < arr.size()));
+        CHECK(search.findFirst(arr.data(), arr.size(), item) == first);
+        CHECK(search.countMatches(arr.data(), arr.size(), item) == (size_t)count(arr.begin(), arr.end(), item));
+        vector<size_t> all = search.findAll(arr.data(), arr.size(), item);
+        CHECK(all.size() == (size_t)count(arr.begin(), arr.end(), item) && is_sorted(all.begin(), all.end()));
+    }
+}